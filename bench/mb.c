@@ -0,0 +1,91 @@
+#include "js_main.h"
+#include "mb.h"
+
+#define MB_CALIBRATE_NS  10000000ULL     /* 10ms */
+#define MB_TARGET_NS     500000000ULL    /* 0.5s */
+
+uint64_t           mb_allocs;
+volatile uint64_t  mb_sink;
+
+static const char *mb_filter;
+
+/* ── Allocation counting ──────────────────────────────────────────────── */
+
+/*
+ * Linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc, so every
+ * call from jsbench and QuickJS objects lands here first.  Calls libc
+ * makes internally (strdup, stdio) are not seen.
+ */
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    mb_allocs++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size) {
+    mb_allocs++;
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    mb_allocs++;
+    return __real_realloc(ptr, size);
+}
+
+/* ── Runner ───────────────────────────────────────────────────────────── */
+
+bool mb_enabled(const char *name) {
+    return mb_filter == NULL || strstr(name, mb_filter) != NULL;
+}
+
+void mb_run(const char *name, mb_func_t fn, void *arg) {
+    uint64_t n, start, elapsed, allocs;
+
+    if (!mb_enabled(name)) return;
+
+    /* Warm caches and let buffers reach their steady size */
+    fn(arg, 1);
+
+    for (n = 1; ; n *= 2) {
+        start = js_now_ns();
+        fn(arg, n);
+        elapsed = js_now_ns() - start;
+        if (elapsed >= MB_CALIBRATE_NS) break;
+    }
+
+    n = (uint64_t) ((double) n * MB_TARGET_NS / elapsed);
+    if (n == 0) n = 1;
+
+    allocs = mb_allocs;
+    start = js_now_ns();
+    fn(arg, n);
+    elapsed = js_now_ns() - start;
+    allocs = mb_allocs - allocs;
+
+    printf("  %-30s %12.1f %10.2f %12lu\n", name,
+           (double) elapsed / n, (double) allocs / n, (unsigned long) n);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 2) {
+        fprintf(stderr, "Usage: %s [filter]\n", argv[0]);
+        return 1;
+    }
+
+    if (argc == 2 && argv[1][0] != '\0') mb_filter = argv[1];
+
+    printf("  %-30s %12s %10s %12s\n", "benchmark", "ns/op", "allocs/op",
+           "ops");
+
+    mb_http();
+    mb_stats();
+    mb_web();
+    mb_timer();
+
+    return 0;
+}
@@ -0,0 +1,39 @@
+#ifndef MB_H
+#define MB_H
+
+/* ── Microbenchmark harness ───────────────────────────────────────────── */
+
+/*
+ * Each benchmark is a function running its operation n times.  mb_run()
+ * doubles n until a run takes long enough to time, scales it to the
+ * target run time and reports the time and the malloc/calloc/realloc
+ * calls of that last run per operation.  Setup belongs outside the
+ * function so only the operation itself is counted.
+ */
+
+typedef void (*mb_func_t)(void *arg, uint64_t n);
+
+extern uint64_t           mb_allocs;     /* allocator calls so far */
+extern volatile uint64_t  mb_sink;       /* keeps results alive */
+
+bool mb_enabled(const char *name);
+void mb_run(const char *name, mb_func_t fn, void *arg);
+
+/* xorshift64, deterministic across runs */
+static inline uint64_t mb_rand(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+/* ── Suites ───────────────────────────────────────────────────────────── */
+
+void mb_http(void);
+void mb_stats(void);
+void mb_web(void);
+void mb_timer(void);
+
+#endif /* MB_H */
@@ -0,0 +1,202 @@
+#include "js_main.h"
+#include "mb.h"
+#include <stdarg.h>
+
+#define MB_LARGE_BODY    (64 * 1024)
+#define MB_READ_SIZE     (16 * 1024)     /* one socket read */
+#define MB_CHUNKS        16
+#define MB_CHUNK_SIZE    256
+#define MB_MANY_HEADERS  40
+
+typedef struct {
+    js_buf_t            response;
+    size_t              read_size;       /* bytes per feed() call */
+    js_http_response_t  parsed;
+} mb_feed_t;
+
+typedef struct {
+    js_http_response_t  parsed;
+    js_buf_t            packed;
+    JSContext          *ctx;
+} mb_headers_t;
+
+static void mb_append(js_buf_t *b, const char *data, size_t len) {
+    if (js_buf_ensure(b, b->len + len) < 0) abort();
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+}
+
+static void mb_printf(js_buf_t *b, const char *fmt, ...) {
+    char     line[256];
+    int      n;
+    va_list  ap;
+
+    va_start(ap, fmt);
+    n = vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+
+    mb_append(b, line, (size_t) n);
+}
+
+/* ── Responses ────────────────────────────────────────────────────────── */
+
+static void mb_response_small(js_buf_t *b) {
+    mb_printf(b, "HTTP/1.1 200 OK\r\n"
+                 "Content-Type: text/plain\r\n"
+                 "Content-Length: 2\r\n"
+                 "\r\n"
+                 "ok");
+}
+
+static void mb_response_large(js_buf_t *b) {
+    char  body[1024];
+
+    memset(body, 'x', sizeof(body));
+
+    mb_printf(b, "HTTP/1.1 200 OK\r\n"
+                 "Content-Type: application/octet-stream\r\n"
+                 "Content-Length: %d\r\n"
+                 "\r\n", MB_LARGE_BODY);
+
+    for (int i = 0; i < MB_LARGE_BODY / (int) sizeof(body); i++)
+        mb_append(b, body, sizeof(body));
+}
+
+static void mb_response_chunked(js_buf_t *b) {
+    char  chunk[MB_CHUNK_SIZE];
+
+    memset(chunk, 'x', sizeof(chunk));
+
+    mb_printf(b, "HTTP/1.1 200 OK\r\n"
+                 "Content-Type: text/plain\r\n"
+                 "Transfer-Encoding: chunked\r\n"
+                 "\r\n");
+
+    for (int i = 0; i < MB_CHUNKS; i++) {
+        mb_printf(b, "%x\r\n", MB_CHUNK_SIZE);
+        mb_append(b, chunk, sizeof(chunk));
+        mb_printf(b, "\r\n");
+    }
+
+    mb_printf(b, "0\r\n\r\n");
+}
+
+static void mb_response_headers(js_buf_t *b) {
+    mb_printf(b, "HTTP/1.1 200 OK\r\n");
+
+    for (int i = 0; i < MB_MANY_HEADERS - 1; i++)
+        mb_printf(b, "X-Header-%02d: value-%d-abcdefghijklmnopqrstuvwxyz\r\n",
+                  i, i);
+
+    mb_printf(b, "Content-Length: 2\r\n\r\nok");
+}
+
+static int mb_feed_all(js_http_response_t *r, const char *data, size_t len,
+                       size_t read_size) {
+    int rc = 0;
+
+    js_http_response_reset(r);
+
+    for (size_t off = 0; off < len && rc == 0; off += read_size) {
+        size_t n = len - off < read_size ? len - off : read_size;
+        rc = js_http_response_feed(r, data + off, n);
+    }
+
+    return rc;
+}
+
+/* ── Benchmarks ───────────────────────────────────────────────────────── */
+
+static void mb_feed(void *arg, uint64_t n) {
+    mb_feed_t *f = arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        mb_feed_all(&f->parsed, f->response.data, f->response.len,
+                    f->read_size);
+        mb_sink += f->parsed.body_len;
+    }
+}
+
+static void mb_headers_pack(void *arg, uint64_t n) {
+    mb_headers_t *h = arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        js_headers_pack(&h->parsed, &h->packed);
+        mb_sink += h->packed.len;
+    }
+}
+
+/* What a fetch() response pays to expose the parsed headers to JS */
+static void mb_headers_from_http(void *arg, uint64_t n) {
+    mb_headers_t *h = arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        js_headers_pack(&h->parsed, &h->packed);
+        JSValue obj = js_headers_from_packed(h->ctx, h->packed.data,
+                                             h->parsed.header_count);
+        JS_FreeValue(h->ctx, obj);
+    }
+}
+
+static void mb_feed_case(const char *name, void (*build)(js_buf_t *),
+                         size_t read_size) {
+    mb_feed_t  f;
+
+    if (!mb_enabled(name)) return;
+
+    js_buf_init(&f.response);
+    build(&f.response);
+    f.read_size = read_size ? read_size : f.response.len;
+
+    js_http_response_init(&f.parsed);
+
+    if (mb_feed_all(&f.parsed, f.response.data, f.response.len,
+                    f.read_size) != 1)
+    {
+        fprintf(stderr, "Error: %s: response did not parse\n", name);
+        exit(1);
+    }
+
+    mb_run(name, mb_feed, &f);
+
+    js_http_response_free(&f.parsed);
+    js_buf_free(&f.response);
+}
+
+void mb_http(void) {
+    mb_headers_t  h;
+    js_buf_t      response;
+
+    mb_feed_case("feed small", mb_response_small, 0);
+    mb_feed_case("feed large 64k/16k reads", mb_response_large, MB_READ_SIZE);
+    mb_feed_case("feed chunked 16x256", mb_response_chunked, 0);
+    mb_feed_case("feed 40 headers", mb_response_headers, 0);
+
+    if (!mb_enabled("headers pack 40") && !mb_enabled("headers from http 40"))
+        return;
+
+    js_buf_init(&response);
+    mb_response_headers(&response);
+
+    js_http_response_init(&h.parsed);
+    mb_feed_all(&h.parsed, response.data, response.len, response.len);
+    js_buf_init(&h.packed);
+
+    mb_run("headers pack 40", mb_headers_pack, &h);
+
+    if (mb_enabled("headers from http 40")) {
+        h.ctx = js_vm_create();
+        if (h.ctx == NULL) {
+            fprintf(stderr, "Error: failed to create JS context\n");
+            exit(1);
+        }
+
+        mb_run("headers from http 40", mb_headers_from_http, &h);
+
+        js_vm_free(h.ctx);
+    }
+
+    js_buf_free(&h.packed);
+    js_http_response_free(&h.parsed);
+    js_buf_free(&response);
+}
@@ -0,0 +1,78 @@
+#include "js_main.h"
+#include "mb.h"
+
+#define MB_SAMPLES  4096                 /* power of two */
+
+typedef struct {
+    js_hist_t  hist;
+    js_hist_t  other;
+    double     samples[MB_SAMPLES];
+} mb_hist_t;
+
+static const double  mb_percentiles[] = { 50, 90, 99, 99.9 };
+
+/* Mostly sub-millisecond with a tail into the coarse slots */
+static void mb_hist_samples(mb_hist_t *b) {
+    uint64_t  seed = 0x9e3779b97f4a7c15ULL;
+
+    for (int i = 0; i < MB_SAMPLES; i++) {
+        uint64_t r = mb_rand(&seed);
+        double   us = 50 + (double) (r % 950);
+
+        if (r % 100 == 0) us *= 50;
+        b->samples[i] = us;
+    }
+}
+
+/* ── Benchmarks ───────────────────────────────────────────────────────── */
+
+static void mb_hist_add(void *arg, uint64_t n) {
+    mb_hist_t *b = arg;
+
+    for (uint64_t i = 0; i < n; i++)
+        js_hist_add(&b->hist, b->samples[i & (MB_SAMPLES - 1)]);
+}
+
+static void mb_hist_merge(void *arg, uint64_t n) {
+    mb_hist_t *b = arg;
+
+    for (uint64_t i = 0; i < n; i++)
+        js_hist_merge(&b->hist, &b->other);
+}
+
+static void mb_hist_percentile(void *arg, uint64_t n) {
+    mb_hist_t *b = arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        double p = mb_percentiles[i % countof(mb_percentiles)];
+        mb_sink += (uint64_t) js_hist_percentile(&b->hist, p);
+    }
+}
+
+void mb_stats(void) {
+    mb_hist_t *b = malloc(sizeof(mb_hist_t));
+
+    if (b == NULL) {
+        fprintf(stderr, "Error: out of memory\n");
+        exit(1);
+    }
+
+    mb_hist_samples(b);
+
+    js_hist_init(&b->hist);
+    mb_run("hist add", mb_hist_add, b);
+
+    js_hist_init(&b->other);
+    for (int i = 0; i < MB_SAMPLES; i++)
+        js_hist_add(&b->other, b->samples[i]);
+
+    mb_run("hist merge", mb_hist_merge, b);
+
+    js_hist_init(&b->hist);
+    for (int i = 0; i < MB_SAMPLES; i++)
+        js_hist_add(&b->hist, b->samples[i]);
+
+    mb_run("hist percentile", mb_hist_percentile, b);
+
+    free(b);
+}
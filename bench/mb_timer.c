@@ -0,0 +1,90 @@
+#include "js_main.h"
+#include "mb.h"
+
+#define MB_TIMERS   65536                /* power of two */
+#define MB_STEP_US  16                   /* clock advance per operation */
+
+/*
+ * A wheel as full as a large keep-alive run keeps it: one timeout per
+ * connection, moved on every request and re-armed when it fires.
+ */
+typedef struct {
+    js_timers_t  timers;
+    js_timer_t   timer[MB_TIMERS];
+    js_usec_t    now;
+    uint64_t     seed;
+} mb_wheel_t;
+
+/* 1ms .. ~1s */
+static js_usec_t mb_timeout(mb_wheel_t *w) {
+    return 1000 + mb_rand(&w->seed) % 1000000;
+}
+
+static void mb_timer_handler(js_timer_t *timer, void *data) {
+    mb_wheel_t *w = data;
+
+    js_timer_add(&w->timers, timer, mb_timeout(w));
+}
+
+static void mb_wheel_init(mb_wheel_t *w) {
+    w->now = 1000000;
+    w->seed = 0x2545f4914f6cdd1dULL;
+
+    js_timers_init(&w->timers, w->now);
+
+    for (int i = 0; i < MB_TIMERS; i++) {
+        memset(&w->timer[i], 0, sizeof(js_timer_t));
+        w->timer[i].handler = mb_timer_handler;
+        w->timer[i].data = w;
+        js_timer_add(&w->timers, &w->timer[i], mb_timeout(w));
+    }
+}
+
+/* ── Benchmarks ───────────────────────────────────────────────────────── */
+
+static void mb_timer_churn(void *arg, uint64_t n) {
+    mb_wheel_t *w = arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        js_timer_t *t = &w->timer[mb_rand(&w->seed) & (MB_TIMERS - 1)];
+
+        js_timer_delete(&w->timers, t);
+        js_timer_add(&w->timers, t, mb_timeout(w));
+    }
+}
+
+static void mb_timer_churn_expire(void *arg, uint64_t n) {
+    mb_wheel_t *w = arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        js_timer_t *t = &w->timer[mb_rand(&w->seed) & (MB_TIMERS - 1)];
+
+        w->now += MB_STEP_US;
+        js_timer_expire(&w->timers, w->now);
+        mb_sink += js_timer_find(&w->timers);
+
+        js_timer_delete(&w->timers, t);
+        js_timer_add(&w->timers, t, mb_timeout(w));
+    }
+}
+
+void mb_timer(void) {
+    mb_wheel_t *w;
+
+    if (!mb_enabled("timer churn 64k") && !mb_enabled("timer churn+expire 64k"))
+        return;
+
+    w = malloc(sizeof(mb_wheel_t));
+    if (w == NULL) {
+        fprintf(stderr, "Error: out of memory\n");
+        exit(1);
+    }
+
+    mb_wheel_init(w);
+    mb_run("timer churn 64k", mb_timer_churn, w);
+
+    mb_wheel_init(w);
+    mb_run("timer churn+expire 64k", mb_timer_churn_expire, w);
+
+    free(w);
+}
@@ -0,0 +1,64 @@
+#include "js_main.h"
+#include "mb.h"
+
+typedef struct {
+    js_request_t  req;
+    js_buf_t      out;
+} mb_request_t;
+
+static const char  mb_url_short[] = "http://127.0.0.1:8080/";
+static const char  mb_url_long[] =
+    "https://api.example.com:8443/v1/users/12345/orders"
+    "?limit=100&offset=200&sort=desc&fields=id,total,created_at";
+
+/* ── Benchmarks ───────────────────────────────────────────────────────── */
+
+static void mb_parse_url(void *arg, uint64_t n) {
+    js_url_t url;
+
+    for (uint64_t i = 0; i < n; i++) {
+        js_parse_url(arg, &url);
+        mb_sink += url.port;
+    }
+}
+
+static void mb_serialize(void *arg, uint64_t n) {
+    mb_request_t *r = arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        js_request_serialize(&r->req, NULL, &r->out);
+        mb_sink += r->out.len;
+    }
+}
+
+void mb_web(void) {
+    mb_request_t  get, post;
+    char          body[256];
+
+    mb_run("parse url short", mb_parse_url, (void *) mb_url_short);
+    mb_run("parse url long", mb_parse_url, (void *) mb_url_long);
+
+    memset(&get, 0, sizeof(get));
+    js_parse_url(mb_url_short, &get.req.url);
+    get.req.method = "GET";
+    js_buf_init(&get.out);
+
+    mb_run("request serialize GET", mb_serialize, &get);
+
+    memset(body, 'x', sizeof(body));
+
+    memset(&post, 0, sizeof(post));
+    js_parse_url(mb_url_long, &post.req.url);
+    post.req.method = "POST";
+    post.req.headers = "Content-Type: application/json\r\n"
+                       "Authorization: Bearer 0123456789abcdef\r\n"
+                       "Accept: */*\r\n";
+    post.req.body = body;
+    post.req.body_len = sizeof(body);
+    js_buf_init(&post.out);
+
+    mb_run("request serialize POST", mb_serialize, &post);
+
+    js_buf_free(&get.out);
+    js_buf_free(&post.out);
+}
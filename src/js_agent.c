@@ -0,0 +1,570 @@
+#include "js_main.h"
+#include <poll.h>
+
+/*
+ * Control protocol, one TCP connection per run:
+ *
+ *   coordinator -> agent   JOB    token '\0' script name '\0' script source
+ *   agent -> coordinator   READY  run length, s (f64 bits), 0: unknown
+ *   coordinator -> agent   START  wall-clock start time, ns (u64)
+ *   agent -> coordinator   STATS  duration (f64 bits) + js_stats_encode()
+ *                          ERROR  message
+ *
+ * Each message is a big-endian (type, length) header and the payload.
+ * The agent sends READY once the script is loaded and the run set up,
+ * so a broken script fails before anyone starts.
+ *
+ * An agent runs whatever script it is sent, so it takes jobs only from a
+ * coordinator with the same token (JSB_AGENT_TOKEN) and listens on
+ * loopback unless given an address.  Every read has a deadline: a peer
+ * that goes quiet cannot hold the other side forever.
+ */
+
+enum {
+    AGENT_MSG_JOB = 1,
+    AGENT_MSG_READY,
+    AGENT_MSG_START,
+    AGENT_MSG_STATS,
+    AGENT_MSG_ERROR
+};
+
+#define AGENT_MAX_AGENTS    64
+#define AGENT_MAX_MSG       (64 * 1024 * 1024)
+#define AGENT_START_DELAY   1000000000ULL   /* ns from READY to START */
+#define AGENT_TOKEN_ENV     "JSB_AGENT_TOKEN"
+
+/* Deadlines, ns: one exchange, and a run whose length is not known */
+#define AGENT_IO_TIMEOUT    (30 * 1000000000ULL)
+#define AGENT_RUN_TIMEOUT   (24 * 3600 * 1000000000ULL)
+
+/* ── Messages ─────────────────────────────────────────────────────────── */
+
+static int agent_write_all(int fd, const void *data, size_t len) {
+    const char *p = data;
+
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/* Read len bytes by deadline (js_now_ns()) */
+static int agent_read_all(int fd, void *data, size_t len, uint64_t deadline) {
+    char *p = data;
+
+    while (len > 0) {
+        uint64_t now = js_now_ns();
+        if (now >= deadline) {
+            errno = ETIMEDOUT;
+            return -1;
+        }
+
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        int rc = poll(&pfd, 1, (int)((deadline - now + 999999) / 1000000));
+        if (rc < 0 && errno == EINTR) continue;
+        if (rc <= 0) continue;
+
+        ssize_t n = read(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static void agent_put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 7; i >= 0; i--) *p++ = (uint8_t)(v >> (i * 8));
+}
+
+static uint64_t agent_get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v = (v << 8) | p[i];
+    return v;
+}
+
+static int agent_send(int fd, uint32_t type, const void *data, size_t len) {
+    uint8_t hdr[8];
+
+    hdr[0] = (uint8_t)(type >> 24);
+    hdr[1] = (uint8_t)(type >> 16);
+    hdr[2] = (uint8_t)(type >> 8);
+    hdr[3] = (uint8_t)type;
+    hdr[4] = (uint8_t)(len >> 24);
+    hdr[5] = (uint8_t)(len >> 16);
+    hdr[6] = (uint8_t)(len >> 8);
+    hdr[7] = (uint8_t)len;
+
+    if (agent_write_all(fd, hdr, sizeof(hdr)) != 0) return -1;
+    return len ? agent_write_all(fd, data, len) : 0;
+}
+
+/*
+ * Receive one message into payload (NUL-terminated) by deadline; returns
+ * its type
+ */
+static int agent_recv(int fd, js_buf_t *payload, uint64_t deadline) {
+    uint8_t hdr[8];
+
+    if (agent_read_all(fd, hdr, sizeof(hdr), deadline) != 0) return -1;
+
+    uint32_t type = (uint32_t)hdr[0] << 24 | (uint32_t)hdr[1] << 16 |
+                    (uint32_t)hdr[2] << 8 | hdr[3];
+    uint32_t len = (uint32_t)hdr[4] << 24 | (uint32_t)hdr[5] << 16 |
+                   (uint32_t)hdr[6] << 8 | hdr[7];
+
+    if (len > AGENT_MAX_MSG) return -1;
+    if (js_buf_ensure(payload, (size_t)len + 1) < 0) return -1;
+    if (len && agent_read_all(fd, payload->data, len, deadline) != 0)
+        return -1;
+
+    payload->len = len;
+    payload->data[len] = '\0';
+    return (int)type;
+}
+
+static void agent_send_error(int fd, const char *msg) {
+    agent_send(fd, AGENT_MSG_ERROR, msg, strlen(msg));
+}
+
+static void agent_put_f64(uint8_t *p, double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    agent_put_u64(p, bits);
+}
+
+static double agent_get_f64(const uint8_t *p) {
+    uint64_t bits = agent_get_u64(p);
+    double v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+/* The shared token, or NULL (and an error printed) if it is not set */
+static const char *agent_token(void) {
+    const char *token = getenv(AGENT_TOKEN_ENV);
+
+    if (token == NULL || token[0] == '\0') {
+        fprintf(stderr, "Error: set %s to a secret shared by the agents "
+                        "and the coordinator\n", AGENT_TOKEN_ENV);
+        return NULL;
+    }
+    return token;
+}
+
+/* ── Addresses ────────────────────────────────────────────────────────── */
+
+/* Split "host:port", "[v6]:port" or ":port" */
+static int agent_split(const char *s, char *host, size_t host_len,
+                       const char **port) {
+    const char *colon;
+
+    if (s[0] == '[') {
+        const char *rb = strchr(s, ']');
+        if (!rb || rb[1] != ':') return -1;
+        snprintf(host, host_len, "%.*s", (int)(rb - s - 1), s + 1);
+        *port = rb + 2;
+        return 0;
+    }
+
+    colon = strrchr(s, ':');
+    if (!colon || colon[1] == '\0') return -1;
+
+    snprintf(host, host_len, "%.*s", (int)(colon - s), s);
+    *port = colon + 1;
+    return 0;
+}
+
+/* ":port" listens on loopback; other interfaces must be named */
+static const char *agent_host(const char *host, bool listening) {
+    if (host[0] != '\0') return host;
+    return listening ? "127.0.0.1" : NULL;
+}
+
+static int agent_socket(const char *addr, bool listening) {
+    char host[256];
+    const char *port;
+
+    if (agent_split(addr, host, sizeof(host), &port) != 0) {
+        fprintf(stderr, "Error: invalid address '%s' (want host:port)\n", addr);
+        return -1;
+    }
+
+    struct addrinfo hints = {
+        .ai_family = AF_UNSPEC,
+        .ai_socktype = SOCK_STREAM,
+        .ai_flags = listening ? AI_PASSIVE : 0,
+    };
+    struct addrinfo *res = NULL;
+
+    int gai_err = getaddrinfo(agent_host(host, listening), port, &hints, &res);
+    if (gai_err != 0 || !res) {
+        fprintf(stderr, "Error: cannot resolve '%s': %s\n",
+                addr, gai_strerror(gai_err));
+        return -1;
+    }
+
+    int fd = -1;
+
+    for (struct addrinfo *ai = res; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) continue;
+
+        int one = 1;
+        int rc;
+
+        if (listening) {
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            rc = bind(fd, ai->ai_addr, ai->ai_addrlen);
+            if (rc == 0) rc = listen(fd, 16);
+        } else {
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            rc = connect(fd, ai->ai_addr, ai->ai_addrlen);
+        }
+
+        if (rc == 0) break;
+        close(fd);
+        fd = -1;
+    }
+
+    freeaddrinfo(res);
+
+    if (fd < 0) {
+        fprintf(stderr, "Error: cannot %s '%s': %s\n",
+                listening ? "listen on" : "connect to", addr, strerror(errno));
+    }
+    return fd;
+}
+
+/* ── Agent ────────────────────────────────────────────────────────────── */
+
+/*
+ * Called by js_bench_run once the script is loaded and the run set up:
+ * say so, and wait for the start time.  The coordinator collects every
+ * READY within one exchange, so START may take up to two.
+ */
+static int agent_ready(js_bench_result_t *res, double run_sec) {
+    int fd = *(int *)res->data;
+    js_buf_t msg = {0};
+    uint8_t ready[8];
+    int rc = -1;
+
+    agent_put_f64(ready, run_sec);
+
+    if (agent_send(fd, AGENT_MSG_READY, ready, sizeof(ready)) == 0 &&
+        agent_recv(fd, &msg, js_now_ns() + 2 * AGENT_IO_TIMEOUT)
+            == AGENT_MSG_START && msg.len == 8)
+    {
+        res->start_at_ns = agent_get_u64((const uint8_t *)msg.data);
+        rc = 0;
+    } else {
+        fprintf(stderr, "Error: no start time from the coordinator\n");
+    }
+
+    js_buf_free(&msg);
+    return rc;
+}
+
+/*
+ * Run one job.  The script is evaluated from memory under its base name
+ * in the working directory, so files it refers to are found relative to
+ * where the agent was started.
+ */
+static void agent_session(int fd, const char *token) {
+    js_buf_t msg = {0};
+    char path[PATH_MAX];
+    js_bench_result_t *res = NULL;
+
+    if (agent_recv(fd, &msg, js_now_ns() + AGENT_IO_TIMEOUT) != AGENT_MSG_JOB)
+        goto done;
+
+    const char *got = msg.data;
+    size_t got_len = strlen(got);
+    size_t token_len = strlen(token);
+
+    if (got_len >= msg.len) {
+        agent_send_error(fd, "malformed job");
+        goto done;
+    }
+
+    /* Constant time, so the reply time says nothing about the token */
+    if (got_len != token_len || CRYPTO_memcmp(got, token, token_len) != 0) {
+        fprintf(stderr, "Rejected a job with a wrong token\n");
+        agent_send_error(fd, "wrong token");
+        goto done;
+    }
+
+    const char *name = got + got_len + 1;
+    size_t name_len = strlen(name);
+    if (got_len + 1 + name_len >= msg.len) {
+        agent_send_error(fd, "malformed job");
+        goto done;
+    }
+
+    const char *slash = strrchr(name, '/');
+    const char *base = slash ? slash + 1 : name;
+
+    snprintf(path, sizeof(path), "./%s", base[0] ? base : "script.js");
+
+    char *source = strdup(name + name_len + 1);
+    if (!source) {
+        agent_send_error(fd, "out of memory");
+        goto done;
+    }
+
+    printf("Job from coordinator: %s\n", base);
+    fflush(stdout);
+
+    res = calloc(1, sizeof(js_bench_result_t));
+    if (!res) {
+        free(source);
+        agent_send_error(fd, "out of memory");
+        goto done;
+    }
+
+    res->ready = agent_ready;
+    res->data = &fd;
+
+    int rc = js_runtime_run_script(path, source, res);
+    fflush(stdout);
+
+    if (rc != 0 || res->duration_sec <= 0) {
+        agent_send_error(fd, rc != 0 ? "benchmark failed"
+                                     : "script did not run a benchmark");
+        goto done;
+    }
+
+    js_buf_reset(&msg);
+    if (js_buf_ensure(&msg, 8) < 0) goto done;
+    agent_put_f64((uint8_t *)msg.data, res->duration_sec);
+    msg.len = 8;
+
+    if (js_stats_encode(&res->stats, &msg) != 0) {
+        agent_send_error(fd, "out of memory");
+        goto done;
+    }
+
+    agent_send(fd, AGENT_MSG_STATS, msg.data, msg.len);
+
+done:
+    free(res);
+    js_buf_free(&msg);
+}
+
+int js_agent_serve(const char *listen_addr) {
+    const char *token = agent_token();
+    if (!token) return 1;
+
+    int lfd = agent_socket(listen_addr, true);
+    if (lfd < 0) return 1;
+
+    printf("Agent listening on %s%s\n",
+           listen_addr[0] == ':' ? "127.0.0.1" : "", listen_addr);
+    fflush(stdout);
+
+    for (;;) {
+        int fd = accept4(lfd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            fprintf(stderr, "Error: accept: %s\n", strerror(errno));
+            close(lfd);
+            return 1;
+        }
+
+        agent_session(fd, token);
+        close(fd);
+    }
+}
+
+/* ── Coordinator ──────────────────────────────────────────────────────── */
+
+typedef struct {
+    char         addr[256];
+    int          fd;
+    js_stats_t  *stats;
+    double       duration_sec;
+} agent_peer_t;
+
+static void agent_print_peers(agent_peer_t *peers, int n) {
+    printf("  agent                    requests  errors    qps       p99\n");
+
+    for (int i = 0; i < n; i++) {
+        js_stats_t *s = peers[i].stats;
+        char p99_buf[32];
+
+        if (!s) {
+            printf("  %-25sfailed\n", peers[i].addr);
+            continue;
+        }
+
+        double qps = peers[i].duration_sec > 0
+                   ? (double)s->requests / peers[i].duration_sec : 0;
+
+        js_format_duration(js_hist_percentile(&s->latency, 99),
+                           p99_buf, sizeof(p99_buf));
+
+        printf("  %-25s%-10lu%-10lu%-10.1f%-10s\n",
+               peers[i].addr, (unsigned long)s->requests,
+               (unsigned long)s->errors, qps, p99_buf);
+    }
+
+    printf("\n");
+}
+
+int js_agent_coordinate(const char *agents, const char *script_path) {
+    agent_peer_t peers[AGENT_MAX_AGENTS];
+    js_buf_t msg = {0};
+    int npeers = 0;
+    int ret = 1;
+
+    const char *token = agent_token();
+    if (!token) return 1;
+
+    size_t source_len;
+    char *source = js_read_file(script_path, &source_len);
+    if (!source) {
+        fprintf(stderr, "Error: cannot read file '%s': %s\n",
+                script_path, strerror(errno));
+        return 1;
+    }
+
+    /* Connect to every agent and hand it the script */
+    char *list = strdup(agents);
+    char *save = NULL;
+
+    if (!list) {
+        free(source);
+        return 1;
+    }
+
+    for (char *a = strtok_r(list, ",", &save); a && npeers < AGENT_MAX_AGENTS;
+         a = strtok_r(NULL, ",", &save))
+    {
+        agent_peer_t *p = &peers[npeers];
+
+        snprintf(p->addr, sizeof(p->addr), "%s", a);
+        p->stats = NULL;
+        p->duration_sec = 0;
+        p->fd = agent_socket(a, false);
+        if (p->fd < 0) goto done_peers;
+        npeers++;
+    }
+
+    if (npeers == 0) {
+        fprintf(stderr, "Error: no agents given\n");
+        goto done;
+    }
+
+    size_t token_len = strlen(token) + 1;
+    size_t name_len = strlen(script_path) + 1;
+
+    js_buf_reset(&msg);
+    if (js_buf_ensure(&msg, token_len + name_len + source_len) < 0)
+        goto done_peers;
+    memcpy(msg.data, token, token_len);
+    memcpy(msg.data + token_len, script_path, name_len);
+    memcpy(msg.data + token_len + name_len, source, source_len);
+    msg.len = token_len + name_len + source_len;
+
+    for (int i = 0; i < npeers; i++) {
+        if (agent_send(peers[i].fd, AGENT_MSG_JOB, msg.data, msg.len) != 0) {
+            fprintf(stderr, "Error: agent %s: send failed\n", peers[i].addr);
+            goto done_peers;
+        }
+    }
+
+    /* Every agent loads the script and answers within one exchange */
+    uint64_t deadline = js_now_ns() + AGENT_IO_TIMEOUT;
+    double run_sec = 0;
+    bool run_known = true;
+
+    for (int i = 0; i < npeers; i++) {
+        int type = agent_recv(peers[i].fd, &msg, deadline);
+        if (type != AGENT_MSG_READY || msg.len != 8) {
+            fprintf(stderr, "Error: agent %s: %s\n", peers[i].addr,
+                    type == AGENT_MSG_ERROR ? msg.data : "no answer");
+            goto done_peers;
+        }
+
+        double sec = agent_get_f64((const uint8_t *)msg.data);
+        if (sec <= 0) run_known = false;
+        if (sec > run_sec) run_sec = sec;
+    }
+
+    /* Start everyone at the same wall-clock instant */
+    js_realtime_t now;
+    js_realtime(&now);
+
+    uint8_t start[8];
+    agent_put_u64(start, (uint64_t)now.sec * 1000000000ULL +
+                         (uint64_t)now.nsec + AGENT_START_DELAY);
+
+    for (int i = 0; i < npeers; i++) {
+        if (agent_send(peers[i].fd, AGENT_MSG_START, start, sizeof(start)) != 0) {
+            fprintf(stderr, "Error: agent %s: send failed\n", peers[i].addr);
+            goto done_peers;
+        }
+    }
+
+    printf("Running %s on %d agent(s)\n", script_path, npeers);
+    fflush(stdout);
+
+    /* Collect and merge; histograms merge exactly, slot by slot */
+    js_stats_t *total = malloc(sizeof(js_stats_t));
+    if (!total) goto done_peers;
+    js_stats_init(total);
+
+    double duration = 0;
+    int failed = 0;
+
+    /* Results are due when the longest run ends, give or take setup */
+    deadline = js_now_ns() + AGENT_START_DELAY + AGENT_IO_TIMEOUT +
+               (run_known ? (uint64_t)(run_sec * 1e9) : AGENT_RUN_TIMEOUT);
+
+    for (int i = 0; i < npeers; i++) {
+        int type = agent_recv(peers[i].fd, &msg, deadline);
+
+        peers[i].stats = malloc(sizeof(js_stats_t));
+
+        if (type != AGENT_MSG_STATS || msg.len < 8 || !peers[i].stats ||
+            js_stats_decode(peers[i].stats, msg.data + 8, msg.len - 8) != 0)
+        {
+            fprintf(stderr, "Error: agent %s: %s\n", peers[i].addr,
+                    type == AGENT_MSG_ERROR ? msg.data : "no results");
+            free(peers[i].stats);
+            peers[i].stats = NULL;
+            failed++;
+            continue;
+        }
+
+        peers[i].duration_sec = agent_get_f64((const uint8_t *)msg.data);
+
+        js_stats_merge(total, peers[i].stats);
+        if (peers[i].duration_sec > duration) duration = peers[i].duration_sec;
+    }
+
+    if (failed < npeers) {
+        js_stats_print(total, duration);
+
+        agent_print_peers(peers, npeers);
+    }
+
+    ret = failed ? 1 : 0;
+    free(total);
+
+done_peers:
+    for (int i = 0; i < npeers; i++) {
+        if (peers[i].fd >= 0) close(peers[i].fd);
+        free(peers[i].stats);
+    }
+
+done:
+    free(list);
+    free(source);
+    js_buf_free(&msg);
+    return ret;
+}
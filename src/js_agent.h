@@ -0,0 +1,18 @@
+#ifndef JS_AGENT_H
+#define JS_AGENT_H
+
+/* ── Distributed runs ─────────────────────────────────────────────────── */
+
+/*
+ *   jsb agent --listen [host]:port
+ *       Wait for a coordinator and run the scripts it sends, one at a time.
+ *
+ *   jsb run --agents host:port,host:port script.js
+ *       Ship the script to every agent, start them all at the same instant
+ *       and merge their results.
+ */
+
+int js_agent_serve(const char *listen_addr);
+int js_agent_coordinate(const char *agents, const char *script_path);
+
+#endif /* JS_AGENT_H */
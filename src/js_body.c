@@ -0,0 +1,71 @@
+#include "js_main.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+int js_body_open_file(js_body_t *b, const char *path, bool chunked) {
+    struct stat st;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    b->fd = fd;
+    b->size = (uint64_t)st.st_size;
+    b->block = b->size;
+    b->chunked = chunked;
+    return 0;
+}
+
+int js_body_generate(js_body_t *b, uint64_t size, bool chunked) {
+    static const char fill[] = "0123456789abcdefghijklmnopqrstuvwxyz"
+                               "ABCDEFGHIJKLMNOPQRSTUVWXYZ\n";
+    char buf[4096];
+
+    if (size == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int fd = memfd_create("jsb-body", MFD_CLOEXEC);
+    if (fd < 0) return -1;
+
+    uint64_t block = size < JS_BODY_BLOCK ? size : JS_BODY_BLOCK;
+
+    for (size_t i = 0; i < sizeof(buf); i++)
+        buf[i] = fill[i % (sizeof(fill) - 1)];
+
+    for (uint64_t off = 0; off < block; ) {
+        size_t n = block - off < sizeof(buf) ? (size_t)(block - off) : sizeof(buf);
+        ssize_t w = pwrite(fd, buf, n, (off_t)off);
+        if (w <= 0) {
+            close(fd);
+            return -1;
+        }
+        off += (uint64_t)w;
+    }
+
+    b->fd = fd;
+    b->size = size;
+    b->block = block;
+    b->chunked = chunked;
+    return 0;
+}
+
+void js_body_close(js_body_t *b) {
+    if (b->fd >= 0) close(b->fd);
+    b->fd = -1;
+}
+
+/* The header line announcing the body */
+int js_body_header(const js_body_t *b, char *buf, size_t size) {
+    if (b->chunked)
+        return snprintf(buf, size, "Transfer-Encoding: chunked\r\n");
+
+    return snprintf(buf, size, "Content-Length: %lu\r\n",
+                    (unsigned long)b->size);
+}
@@ -0,0 +1,28 @@
+#ifndef JS_BODY_H
+#define JS_BODY_H
+
+/* ── Streamed request body ────────────────────────────────────────────── */
+
+/*
+ * A request body sent straight from a file descriptor after the request
+ * head, never copied into a buffer.  A file body is sent as it is; a
+ * generated body repeats one block of filler data, kept in a memfd,
+ * until size bytes have been sent.  Chunked bodies go out in chunks of
+ * at most JS_BODY_BLOCK bytes.
+ */
+
+#define JS_BODY_BLOCK   (1024 * 1024)
+
+typedef struct {
+    int       fd;           /* -1: no streamed body */
+    uint64_t  size;         /* body length */
+    uint64_t  block;        /* bytes of data in fd, repeated up to size */
+    bool      chunked;      /* Transfer-Encoding: chunked */
+} js_body_t;
+
+int  js_body_open_file(js_body_t *b, const char *path, bool chunked);
+int  js_body_generate(js_body_t *b, uint64_t size, bool chunked);
+void js_body_close(js_body_t *b);
+int  js_body_header(const js_body_t *b, char *buf, size_t size);
+
+#endif /* JS_BODY_H */
@@ -36,6 +36,8 @@ static inline int js_buf_ensure(js_buf_t *b, size_t need) {
     char *data = realloc(b->data, cap);
     if (!data) return -1;
 
+    js_thread()->counters.buf_grows++;
+
     b->data = data;
     b->cap = cap;
     return 0;
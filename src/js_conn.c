@@ -1,28 +1,67 @@
 #include "js_main.h"
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <sys/sendfile.h>
 
-js_conn_t *js_conn_create(const struct sockaddr *addr, socklen_t addr_len,
-                             SSL_CTX *ssl_ctx, const char *hostname) {
-    js_conn_t *c = calloc(1, sizeof(js_conn_t));
-    if (!c) return NULL;
+static void conn_set_quickack(js_conn_t *c) {
+    int one = 1;
+    setsockopt(c->socket.fd, IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one));
+}
 
-    c->socket.fd = socket(addr->sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
-    if (c->socket.fd < 0) {
-        free(c);
-        return NULL;
-    }
+/*
+ * Open a non-blocking socket and start connecting.  With fast open,
+ * connect() returns at once and the SYN leaves with the first write.
+ */
+static int conn_open(js_conn_t *c, const struct sockaddr *addr,
+                     socklen_t addr_len, const js_sockopts_t *opts) {
+    int fd = socket(addr->sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
 
-    /* TCP_NODELAY */
     int one = 1;
-    setsockopt(c->socket.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
 
-    int ret = connect(c->socket.fd, addr, addr_len);
+    if (opts == NULL || opts->nodelay)
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    if (opts) {
+        if (opts->sndbuf > 0)
+            setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &opts->sndbuf, sizeof(int));
+        if (opts->rcvbuf > 0)
+            setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &opts->rcvbuf, sizeof(int));
+        if (opts->congestion[0])
+            setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, opts->congestion,
+                       (socklen_t)strlen(opts->congestion));
+        if (opts->quickack)
+            setsockopt(fd, IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one));
+#ifdef TCP_FASTOPEN_CONNECT
+        if (opts->fast_open)
+            setsockopt(fd, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, &one, sizeof(one));
+#endif
+    }
+
+    int ret = connect(fd, addr, addr_len);
     if (ret < 0 && errno != EINPROGRESS) {
-        close(c->socket.fd);
+        close(fd);
+        return -1;
+    }
+
+    c->socket.fd = fd;
+    c->opts = opts;
+    return 0;
+}
+
+js_conn_t *js_conn_create(const struct sockaddr *addr, socklen_t addr_len,
+                             SSL_CTX *ssl_ctx, const char *hostname,
+                             const js_sockopts_t *opts) {
+    js_conn_t *c = calloc(1, sizeof(js_conn_t));
+    if (!c) return NULL;
+
+    if (conn_open(c, addr, addr_len, opts) != 0) {
         free(c);
         return NULL;
     }
 
     c->state = CONN_CONNECTING;
+    c->connect_ns = js_now_ns();
 
     if (ssl_ctx) {
         c->ssl = js_tls_new(ssl_ctx, c->socket.fd, hostname);
@@ -48,69 +87,342 @@ int js_conn_set_output(js_conn_t *c, const char *data, size_t len) {
     return 0;
 }
 
+static void conn_body_rewind(js_conn_t *c) {
+    c->body_sent = 0;
+    c->chunk_left = 0;
+    c->frame_len = 0;
+    c->frame_pos = 0;
+    c->body_done = false;
+}
+
+void js_conn_set_body(js_conn_t *c, const js_body_t *body) {
+    c->body = body;
+    conn_body_rewind(c);
+}
+
+/* Fail the connection, noting the step it failed in */
+void js_conn_error(js_conn_t *c) {
+    c->failed = c->state;
+    c->state = CONN_ERROR;
+}
+
+/* Count socket reads and writes; errno is left as the call set it */
+static inline ssize_t conn_count_read(ssize_t n) {
+    js_counters_t *k = &js_thread()->counters;
+
+    k->reads++;
+    if (n > 0) k->read_bytes += (uint64_t)n;
+    return n;
+}
+
+static inline ssize_t conn_count_write(ssize_t n) {
+    js_counters_t *k = &js_thread()->counters;
+
+    k->writes++;
+    if (n > 0) k->write_bytes += (uint64_t)n;
+    return n;
+}
+
 static void conn_try_handshake(js_conn_t *c) {
     int ret = js_tls_handshake(c->ssl);
     if (ret == 0) {
+        c->handshake_ns = js_now_ns();
+        js_tls_ktls(c->ssl, &c->ktls_tx, &c->ktls_rx);
         c->state = CONN_WRITING;
     } else if (ret < 0) {
-        c->state = CONN_ERROR;
+        js_conn_error(c);
     }
     /* ret == 1: want more I/O, stay in TLS_HANDSHAKE */
 }
 
-static int conn_do_write(js_conn_t *c) {
-    while (c->out.pos < c->out.len) {
-        ssize_t n;
-        if (c->ssl) {
-            n = js_tls_write(c->ssl, c->out.data + c->out.pos,
-                              c->out.len - c->out.pos);
-        } else {
-            n = write(c->socket.fd, c->out.data + c->out.pos,
-                      c->out.len - c->out.pos);
+static ssize_t conn_send(js_conn_t *c, const void *buf, size_t len) {
+    if (c->ssl && !c->ktls_tx)
+        return conn_count_write(js_tls_write(c->ssl, buf, len));
+
+    ssize_t n = conn_count_write(write(c->socket.fd, buf, len));
+    if (n > 0) c->tx_bytes += (uint64_t)n;
+    return n;
+}
+
+/* Body data at off: sendfile(), or pread() and SSL_write() over TLS */
+static ssize_t conn_send_body(js_conn_t *c, uint64_t off, size_t len) {
+    const js_body_t *b = c->body;
+
+    if (c->ssl == NULL || c->ktls_tx) {
+        off_t o = (off_t)off;
+        ssize_t n = conn_count_write(sendfile(c->socket.fd, b->fd, &o, len));
+        if (n > 0) c->tx_bytes += (uint64_t)n;
+        return n;
+    }
+
+    /* A retry after EAGAIN asks for the same bytes again */
+    char buf[16384];
+    ssize_t n = pread(b->fd, buf, len < sizeof(buf) ? len : sizeof(buf),
+                      (off_t)off);
+    if (n <= 0) {
+        errno = EIO;
+        return -1;
+    }
+    return conn_count_write(js_tls_write(c->ssl, buf, (size_t)n));
+}
+
+/* 1 if the socket is full, -1 (and CONN_ERROR) if the write failed */
+static int conn_write_failed(js_conn_t *c, ssize_t n) {
+    /* EINPROGRESS: fast open sent a SYN, the data waits for it */
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK ||
+                  errno == EINPROGRESS))
+        return 1;
+    js_conn_error(c);
+    return -1;
+}
+
+/*
+ * Send the streamed body.  Returns 0 once all of it is sent, 1 if the
+ * socket is full, -1 on error.
+ */
+static int conn_write_body(js_conn_t *c) {
+    const js_body_t *b = c->body;
+
+    for (;;) {
+        if (c->frame_pos < c->frame_len) {
+            ssize_t n = conn_send(c, c->frame + c->frame_pos,
+                                  c->frame_len - c->frame_pos);
+            if (n <= 0) return conn_write_failed(c, n);
+            c->frame_pos += (size_t)n;
+            continue;
         }
 
-        if (n < 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
-            c->state = CONN_ERROR;
-            return -1;
+        if (c->body_done) return 0;
+
+        if (c->chunk_left > 0) {
+            uint64_t off = c->body_sent % b->block;
+            uint64_t len = b->block - off;
+            if (len > c->chunk_left) len = c->chunk_left;
+
+            ssize_t n = conn_send_body(c, off, (size_t)len);
+            if (n <= 0) return conn_write_failed(c, n);
+            c->body_sent += (uint64_t)n;
+            c->chunk_left -= (uint64_t)n;
+            continue;
         }
-        if (n == 0) {
-            c->state = CONN_ERROR;
-            return -1;
+
+        uint64_t left = b->size - c->body_sent;
+
+        if (!b->chunked) {
+            c->chunk_left = left;
+            c->body_done = (left == 0);
+            continue;
         }
+
+        /* Close the previous chunk and open the next, or the last */
+        uint64_t chunk = left < JS_BODY_BLOCK ? left : JS_BODY_BLOCK;
+
+        c->frame_len = (size_t)snprintf(c->frame, sizeof(c->frame),
+                                        "%s%lx\r\n%s",
+                                        c->body_sent > 0 ? "\r\n" : "",
+                                        (unsigned long)chunk,
+                                        chunk == 0 ? "\r\n" : "");
+        c->frame_pos = 0;
+        c->chunk_left = chunk;
+        c->body_done = (chunk == 0);
+    }
+}
+
+static int conn_do_write(js_conn_t *c) {
+    if (c->out.len == 0) {
+        /* Preconnected with nothing queued: wait for a request */
+        if (c->preconnect) {
+            c->state = CONN_IDLE;
+            return 0;
+        }
+
+        /* The request could not be built */
+        js_conn_error(c);
+        return -1;
+    }
+
+    while (c->out.pos < c->out.len) {
+        ssize_t n = conn_send(c, c->out.data + c->out.pos,
+                              c->out.len - c->out.pos);
+        if (n <= 0) return conn_write_failed(c, n) > 0 ? 0 : -1;
         c->out.pos += (size_t)n;
     }
 
+    if (c->body) {
+        int rc = conn_write_body(c);
+        if (rc != 0) return rc > 0 ? 0 : -1;
+    }
+
+    /* The send timestamp that counts is the one for the last byte */
+    c->tx_ts_key = (uint32_t)(c->tx_bytes - 1);
     c->state = CONN_READING;
     return 0;
 }
 
+/* ── Kernel timestamps ────────────────────────────────────────────────── */
+
+/*
+ * Request software timestamps for bytes sent and received.  Send
+ * timestamps are queued on the error queue, without the payload, and
+ * carry the offset of the last byte they cover (OPT_ID), counted from
+ * here; receive timestamps come with the data.  Plain TCP only: OpenSSL
+ * reads the socket itself.  The socket must be connecting already.
+ */
+int js_conn_timestamping(js_conn_t *c) {
+    unsigned flags = SOF_TIMESTAMPING_OPT_TSONLY | SOF_TIMESTAMPING_OPT_ID |
+                     SOF_TIMESTAMPING_TX_SOFTWARE |
+                     SOF_TIMESTAMPING_RX_SOFTWARE |
+                     SOF_TIMESTAMPING_SOFTWARE;
+
+    if (c->ssl) return -1;
+
+    if (setsockopt(c->socket.fd, SOL_SOCKET, SO_TIMESTAMPING,
+                   &flags, sizeof(flags)) < 0)
+        return -1;
+
+    c->timestamping = true;
+    c->tx_bytes = 0;
+    return 0;
+}
+
+/* The software timestamp in a message's control data, 0 if none */
+static uint64_t conn_cmsg_timestamp(struct msghdr *msg) {
+    for (struct cmsghdr *cm = CMSG_FIRSTHDR(msg); cm; cm = CMSG_NXTHDR(msg, cm)) {
+        if (cm->cmsg_level != SOL_SOCKET || cm->cmsg_type != SCM_TIMESTAMPING)
+            continue;
+
+        struct timespec ts[3];
+        memcpy(ts, CMSG_DATA(cm), sizeof(ts));
+
+        return (uint64_t)ts[0].tv_sec * 1000000000ULL +
+               (uint64_t)ts[0].tv_nsec;
+    }
+    return 0;
+}
+
+/* The OPT_ID key of a send timestamp: the offset of the last byte sent */
+static bool conn_cmsg_tskey(struct msghdr *msg, uint32_t *key) {
+    for (struct cmsghdr *cm = CMSG_FIRSTHDR(msg); cm; cm = CMSG_NXTHDR(msg, cm)) {
+        if (!(cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) &&
+            !(cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR))
+            continue;
+
+        struct sock_extended_err ee;
+        memcpy(&ee, CMSG_DATA(cm), sizeof(ee));
+
+        if (ee.ee_origin != SO_EE_ORIGIN_TIMESTAMPING) return false;
+        *key = ee.ee_data;
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Collect queued send timestamps.  Only the one for the last byte of the
+ * current request is kept; stamps for earlier writes are dropped.
+ */
+int js_conn_read_errqueue(js_conn_t *c) {
+    int n = 0;
+
+    for (;;) {
+        char ctrl[512];
+        struct msghdr msg = {
+            .msg_control = ctrl,
+            .msg_controllen = sizeof(ctrl),
+        };
+        uint32_t key;
+
+        if (recvmsg(c->socket.fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+            break;
+
+        if (conn_cmsg_tskey(&msg, &key) && key == c->tx_ts_key)
+            c->tx_ts_ns = conn_cmsg_timestamp(&msg);
+        n++;
+    }
+
+    return n;
+}
+
+/* read(), or recvmsg() to pick up the receive timestamp */
+static ssize_t conn_recv(js_conn_t *c, void *buf, size_t len) {
+    if (!c->timestamping) return read(c->socket.fd, buf, len);
+
+    char ctrl[CMSG_SPACE(sizeof(struct timespec) * 3)];
+    struct iovec iov = { .iov_base = buf, .iov_len = len };
+    struct msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = ctrl,
+        .msg_controllen = sizeof(ctrl),
+    };
+
+    ssize_t n = recvmsg(c->socket.fd, &msg, 0);
+    if (n > 0 && c->rx_ts_ns == 0) c->rx_ts_ns = conn_cmsg_timestamp(&msg);
+    return n;
+}
+
+/*
+ * Returns 0 once the socket is drained, 1 if the peer closed, -1 on
+ * error.  With discard set it returns 2 after each buffer read, so the
+ * caller can parse it and say how much body follows.
+ */
 static int conn_do_read(js_conn_t *c) {
     js_buf_t *in = &c->in;
 
     for (;;) {
+        if (c->discard && c->skip > 0) {
+            ssize_t n = conn_count_read(recv(c->socket.fd, NULL, c->skip,
+                                             MSG_TRUNC));
+
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+                js_conn_error(c);
+                return -1;
+            }
+            if (n == 0) {
+                return 1;  /* peer closed */
+            }
+
+            if (c->opts && c->opts->quickack) conn_set_quickack(c);
+
+            c->skip -= (size_t)n;
+            c->skipped += (size_t)n;
+            continue;
+        }
+
         if (js_buf_ensure(in, in->len + JS_READ_BUF_SIZE) < 0) {
-            c->state = CONN_ERROR;
+            js_conn_error(c);
             return -1;
         }
 
+        /*
+         * With kTLS rx the kernel decrypts, but SSL_read() still handles
+         * the non-data records (tickets, alerts) a plain read() fails on
+         */
         ssize_t n;
         if (c->ssl) {
             n = js_tls_read(c->ssl, in->data + in->len, in->cap - in->len);
         } else {
-            n = read(c->socket.fd, in->data + in->len, in->cap - in->len);
+            n = conn_recv(c, in->data + in->len, in->cap - in->len);
         }
 
+        conn_count_read(n);
+
         if (n < 0) {
             if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
-            c->state = CONN_ERROR;
+            js_conn_error(c);
             return -1;
         }
         if (n == 0) {
             return 1;  /* peer closed */
         }
 
+        /* The kernel drops out of quickack mode on its own; re-arm it */
+        if (c->opts && c->opts->quickack) conn_set_quickack(c);
+
         in->len += (size_t)n;
+
+        if (c->discard) return 2;
     }
 }
 
@@ -121,10 +433,12 @@ void js_conn_write(js_conn_t *c) {
             socklen_t len = sizeof(err);
             getsockopt(c->socket.fd, SOL_SOCKET, SO_ERROR, &err, &len);
             if (err) {
-                c->state = CONN_ERROR;
+                js_conn_error(c);
                 return;
             }
 
+            c->connected_ns = js_now_ns();
+
             if (c->ssl) {
                 c->state = CONN_TLS_HANDSHAKE;
                 conn_try_handshake(c);
@@ -150,6 +464,23 @@ void js_conn_write(js_conn_t *c) {
     }
 }
 
+/* An idle connection only becomes readable when the peer closes it */
+static int conn_check_idle(js_conn_t *c) {
+    char b;
+    ssize_t n = conn_count_read(recv(c->socket.fd, &b, 1,
+                                     MSG_PEEK | MSG_DONTWAIT));
+
+    if (n == 0) {
+        js_conn_error(c);
+        return 1;
+    }
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        js_conn_error(c);
+        return -1;
+    }
+    return 0;
+}
+
 int js_conn_read(js_conn_t *c) {
     switch (c->state) {
         case CONN_TLS_HANDSHAKE:
@@ -157,6 +488,8 @@ int js_conn_read(js_conn_t *c) {
             return 0;
         case CONN_READING:
             return conn_do_read(c);
+        case CONN_IDLE:
+            return conn_check_idle(c);
         default:
             return 0;
     }
@@ -167,11 +500,22 @@ void js_conn_reuse(js_conn_t *c) {
     js_buf_reset(&c->in);
     c->state = CONN_WRITING;
     c->out.pos = 0;
+    conn_body_rewind(c);
+    c->tx_ts_ns = 0;
+    c->rx_ts_ns = 0;
+}
+
+void js_conn_idle(js_conn_t *c) {
+    /* Keep the connection open with nothing queued */
+    js_buf_reset(&c->in);
+    js_buf_reset(&c->out);
+    c->body = NULL;
+    c->state = CONN_IDLE;
 }
 
 void js_conn_reset(js_conn_t *c, const struct sockaddr *addr,
                     socklen_t addr_len, SSL_CTX *ssl_ctx,
-                    const char *hostname) {
+                    const char *hostname, const js_sockopts_t *opts) {
     /* Close old connection */
     if (c->ssl) {
         js_tls_free(c->ssl);
@@ -183,25 +527,26 @@ void js_conn_reset(js_conn_t *c, const struct sockaddr *addr,
     js_buf_reset(&c->in);
 
     /* New socket */
-    c->socket.fd = socket(addr->sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
-    if (c->socket.fd < 0) {
-        c->state = CONN_ERROR;
-        return;
-    }
-
-    int one = 1;
-    setsockopt(c->socket.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
-
-    int ret = connect(c->socket.fd, addr, addr_len);
-    if (ret < 0 && errno != EINPROGRESS) {
-        close(c->socket.fd);
+    if (conn_open(c, addr, addr_len, opts) != 0) {
         c->socket.fd = -1;
+        c->failed = CONN_CONNECTING;
         c->state = CONN_ERROR;
         return;
     }
 
     c->state = CONN_CONNECTING;
     c->out.pos = 0;
+    conn_body_rewind(c);
+    c->requests = 0;
+    c->connect_ns = js_now_ns();
+    c->connected_ns = 0;
+    c->handshake_ns = 0;
+    c->ktls_tx = false;
+    c->ktls_rx = false;
+    c->timestamping = false;
+    c->tx_bytes = 0;
+    c->tx_ts_ns = 0;
+    c->rx_ts_ns = 0;
 
     if (ssl_ctx) {
         c->ssl = js_tls_new(ssl_ctx, c->socket.fd, hostname);
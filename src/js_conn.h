@@ -9,12 +9,24 @@ typedef enum {
     CONN_WRITING,
     CONN_READING,
     CONN_DONE,
+    CONN_IDLE,           /* connected, nothing to send */
     CONN_ERROR
 } conn_state_t;
 
+/* Socket options, applied before connect() */
+typedef struct {
+    bool             nodelay;         /* TCP_NODELAY */
+    bool             quickack;        /* TCP_QUICKACK, re-armed after reads */
+    bool             fast_open;       /* TCP_FASTOPEN_CONNECT */
+    int              sndbuf;          /* SO_SNDBUF, 0: system default */
+    int              rcvbuf;          /* SO_RCVBUF, 0: system default */
+    char             congestion[16];  /* TCP_CONGESTION, "": default */
+} js_sockopts_t;
+
 typedef struct js_conn {
     js_event_t       socket;  /* must be first: cast js_event_t* → js_conn_t* */
     conn_state_t     state;
+    conn_state_t     failed;  /* the state it was in when it hit CONN_ERROR */
     SSL             *ssl;
 
     /* I/O buffers */
@@ -24,19 +36,91 @@ typedef struct js_conn {
     /* For round-robin in array mode */
     int              req_index;
 
+    /* Connection number, exposed to request templates as ${conn} */
+    int              id;
+
+    /* Index of the target address, for multi-address runs */
+    int              addr;
+
+    /* Responses received since the connection was opened */
+    int              requests;
+
+    /*
+     * Opened ahead of the run (bench.preconnect): once connected with
+     * nothing queued it settles in CONN_IDLE.  Otherwise an empty request
+     * is an error.
+     */
+    bool             preconnect;
+
+    /*
+     * kTLS engaged after the handshake: with tx the kernel encrypts, so
+     * writes and sendfile() go to the socket directly
+     */
+    bool             ktls_tx;
+    bool             ktls_rx;
+
+    /* Setup timing: connect() called, TCP connected, TLS finished */
+    uint64_t         connect_ns;
+    uint64_t         connected_ns;
+    uint64_t         handshake_ns;
+
+    /*
+     * SO_TIMESTAMPING: when the request's last byte left the stack and
+     * when the first response bytes arrived, in the kernel's clock.  Send
+     * stamps are matched by tx_ts_key, the offset of that last byte among
+     * the tx_bytes written since timestamping began.
+     */
+    bool             timestamping;
+    uint64_t         tx_bytes;
+    uint32_t         tx_ts_key;
+    uint64_t         tx_ts_ns;
+    uint64_t         rx_ts_ns;
+
+    /*
+     * Drop response bodies in the kernel with MSG_TRUNC instead of
+     * copying them into in.  Before each js_conn_read() the caller sets
+     * skip to the body bytes still expected; the bytes dropped are added
+     * to skipped.  Plain TCP only.
+     */
+    bool             discard;
+    size_t           skip;
+    size_t           skipped;
+
+    /*
+     * Body streamed after out, and how far it got: body bytes sent,
+     * bytes left in the current chunk, and chunk framing still to send
+     */
+    const js_body_t *body;
+    uint64_t         body_sent;
+    uint64_t         chunk_left;
+    char             frame[32];
+    size_t           frame_len;
+    size_t           frame_pos;
+    bool             body_done;
+
+    /* Options the socket was opened with (NULL: TCP_NODELAY only) */
+    const js_sockopts_t *opts;
+
     /* User data (for JS callbacks etc.) */
     void            *udata;
 } js_conn_t;
 
 js_conn_t *js_conn_create(const struct sockaddr *addr, socklen_t addr_len,
-                             SSL_CTX *ssl_ctx, const char *hostname);
+                             SSL_CTX *ssl_ctx, const char *hostname,
+                             const js_sockopts_t *opts);
 void        js_conn_free(js_conn_t *c);
 int         js_conn_set_output(js_conn_t *c, const char *data, size_t len);
+void        js_conn_set_body(js_conn_t *c, const js_body_t *body);
 void        js_conn_reset(js_conn_t *c, const struct sockaddr *addr,
                            socklen_t addr_len, SSL_CTX *ssl_ctx,
-                           const char *hostname);
+                           const char *hostname,
+                           const js_sockopts_t *opts);
 void        js_conn_reuse(js_conn_t *c);
+void        js_conn_idle(js_conn_t *c);
+void        js_conn_error(js_conn_t *c);
 void        js_conn_write(js_conn_t *c);
 int         js_conn_read(js_conn_t *c);
+int         js_conn_timestamping(js_conn_t *c);
+int         js_conn_read_errqueue(js_conn_t *c);
 
 #endif /* JS_CONN_H */
@@ -17,8 +17,7 @@ js_engine_t *js_engine_create(void)
         return NULL;
     }
 
-    js_timers_init(&engine->timers);
-    engine->timers.now = (js_msec_t) (js_now_ns() / 1000000);
+    js_timers_init(&engine->timers, js_now_ns() / 1000);
 
     return engine;
 }
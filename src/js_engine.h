@@ -6,6 +6,7 @@ typedef struct js_engine_s js_engine_t;
 struct js_engine_s {
     int epfd;
     js_timers_t timers;
+    uint64_t wakeup_ns;     /* when epoll_wait() last returned events */
 };
 
 js_engine_t *js_engine_create(void);
@@ -1,6 +1,8 @@
 #include "js_main.h"
 
 int js_epoll_add(js_engine_t *engine, js_event_t *ev, uint32_t events) {
+    js_thread()->counters.epoll_ctls++;
+
     struct epoll_event e = {
         .events = events,
         .data.ptr = ev
@@ -9,6 +11,8 @@ int js_epoll_add(js_engine_t *engine, js_event_t *ev, uint32_t events) {
 }
 
 int js_epoll_mod(js_engine_t *engine, js_event_t *ev, uint32_t events) {
+    js_thread()->counters.epoll_ctls++;
+
     struct epoll_event e = {
         .events = events,
         .data.ptr = ev
@@ -17,17 +21,55 @@ int js_epoll_mod(js_engine_t *engine, js_event_t *ev, uint32_t events) {
 }
 
 int js_epoll_del(js_engine_t *engine, js_event_t *ev) {
+    js_thread()->counters.epoll_ctls++;
     return epoll_ctl(engine->epfd, EPOLL_CTL_DEL, ev->fd, NULL);
 }
 
-int js_epoll_poll(js_engine_t *engine, int timeout_ms) {
+/*
+ * Sleep with microsecond precision where the kernel has epoll_pwait2()
+ * (5.11), so paced sends and short timers are not rounded up to the next
+ * millisecond.  Older kernels fall back to epoll_wait().
+ */
+static int epoll_wait_us(int epfd, struct epoll_event *events, int max,
+                         int64_t timeout_us) {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 35)
+    static atomic_bool no_pwait2;
+
+    if (timeout_us > 0 && !atomic_load_explicit(&no_pwait2,
+                                                memory_order_relaxed))
+    {
+        struct timespec ts = {
+            .tv_sec = timeout_us / 1000000,
+            .tv_nsec = (timeout_us % 1000000) * 1000,
+        };
+
+        int n = epoll_pwait2(epfd, events, max, &ts, NULL);
+        if (n >= 0 || errno != ENOSYS) return n;
+
+        atomic_store_explicit(&no_pwait2, true, memory_order_relaxed);
+    }
+#endif
+
+    int timeout_ms = timeout_us < 0 ? -1
+                   : timeout_us >= (int64_t) INT_MAX * 1000 ? INT_MAX
+                   : (int) ((timeout_us + 999) / 1000);
+    return epoll_wait(epfd, events, max, timeout_ms);
+}
+
+int js_epoll_poll(js_engine_t *engine, int64_t timeout_us) {
     struct epoll_event events[256];
 
-    int n = epoll_wait(engine->epfd, events, 256, timeout_ms);
+    js_thread()->counters.epoll_waits++;
+
+    int n = epoll_wait_us(engine->epfd, events, 256, timeout_us);
     if (n < 0) {
         return (errno == EINTR) ? 0 : -1;
     }
 
+    js_thread()->counters.epoll_events += (uint64_t) n;
+
+    if (n > 0) engine->wakeup_ns = js_now_ns();
+
     for (int i = 0; i < n; i++) {
         js_event_t *ev = events[i].data.ptr;
         uint32_t e = events[i].events;
@@ -40,5 +82,5 @@ int js_epoll_poll(js_engine_t *engine, int timeout_ms) {
         }
     }
 
-    return 0;
+    return n;
 }
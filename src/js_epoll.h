@@ -17,6 +17,6 @@ struct js_event_s {
 int     js_epoll_add(js_engine_t *engine, js_event_t *ev, uint32_t events);
 int     js_epoll_mod(js_engine_t *engine, js_event_t *ev, uint32_t events);
 int     js_epoll_del(js_engine_t *engine, js_event_t *ev);
-int     js_epoll_poll(js_engine_t *engine, int timeout_ms);
+int     js_epoll_poll(js_engine_t *engine, int64_t timeout_us);   /* events, or -1 */
 
 #endif /* JS_EPOLL_H */
@@ -233,7 +233,7 @@ static JSValue js_fetch(JSContext *ctx, JSValueConst this_val,
     /* Create TLS context if needed */
     SSL_CTX *ssl_ctx = NULL;
     if (url.is_tls) {
-        ssl_ctx = js_tls_ctx_create();
+        ssl_ctx = js_tls_ctx_create(NULL);
         if (!ssl_ctx) {
             js_buf_free(&raw);
             freeaddrinfo(res);
@@ -245,7 +245,8 @@ static JSValue js_fetch(JSContext *ctx, JSValueConst this_val,
     }
 
     /* Create connection */
-    js_conn_t *conn = js_conn_create(res->ai_addr, res->ai_addrlen, ssl_ctx, url.host);
+    js_conn_t *conn = js_conn_create(res->ai_addr, res->ai_addrlen, ssl_ctx,
+                                     url.host, NULL);
     freeaddrinfo(res);
     if (!conn) {
         free(raw.data);
@@ -302,8 +303,8 @@ static JSValue js_fetch(JSContext *ctx, JSValueConst this_val,
     f->timer.data = f;
 
     js_engine_t *engine = js_thread()->engine;
-    engine->timers.now = (js_msec_t)(js_now_ns() / 1000000);
-    js_timer_add(&engine->timers, &f->timer, 30 * 1000);
+    engine->timers.now = js_now_ns() / 1000;
+    js_timer_add(&engine->timers, &f->timer, 30 * 1000000);
 
     js_epoll_add(engine, &conn->socket, EPOLLIN | EPOLLOUT | EPOLLET);
     js_loop_add(loop, p);
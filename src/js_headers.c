@@ -150,13 +150,43 @@ static JSValue js_headers_new_obj(JSContext *ctx, js_headers_t *h) {
 
 /* ── Public API ──────────────────────────────────────────────────────── */
 
-JSValue js_headers_from_http(JSContext *ctx, const js_http_response_t *parsed) {
+/*
+ * Pack parsed headers as consecutive "name\0value\0" pairs.  This is the
+ * compact form a Response keeps until script code asks for .headers.
+ */
+int js_headers_pack(const js_http_response_t *parsed, js_buf_t *out) {
+    size_t need = 0;
+
+    for (int i = 0; i < parsed->header_count; i++) {
+        need += strlen(parsed->headers[i].name) + 1;
+        need += strlen(parsed->headers[i].value) + 1;
+    }
+
+    js_buf_reset(out);
+    if (need == 0) return 0;
+    if (js_buf_ensure(out, need) < 0) return -1;
+
+    for (int i = 0; i < parsed->header_count; i++) {
+        size_t nlen = strlen(parsed->headers[i].name) + 1;
+        size_t vlen = strlen(parsed->headers[i].value) + 1;
+        memcpy(out->data + out->len, parsed->headers[i].name, nlen);
+        out->len += nlen;
+        memcpy(out->data + out->len, parsed->headers[i].value, vlen);
+        out->len += vlen;
+    }
+
+    return 0;
+}
+
+JSValue js_headers_from_packed(JSContext *ctx, const char *data, int count) {
     js_headers_t *h = js_headers_create(ctx);
+    const char *p = data;
 
-    if (parsed) {
-        for (int i = 0; i < parsed->header_count; i++) {
-            js_headers_set(h, parsed->headers[i].name, parsed->headers[i].value);
-        }
+    for (int i = 0; i < count; i++) {
+        const char *name = p;
+        const char *value = name + strlen(name) + 1;
+        js_headers_set(h, name, value);
+        p = value + strlen(value) + 1;
     }
 
     return js_headers_new_obj(ctx, h);
@@ -34,6 +34,7 @@ typedef struct {
     char              *body;
     size_t             body_len;
     size_t             body_cap;
+    size_t             body_skipped;    /* dropped unseen, not in body */
     size_t             content_length;
     bool               chunked;
 
@@ -57,6 +58,8 @@ void        js_http_response_init(js_http_response_t *r);
 void        js_http_response_free(js_http_response_t *r);
 void        js_http_response_reset(js_http_response_t *r);
 int         js_http_response_feed(js_http_response_t *r, const char *data, size_t len);
+size_t      js_http_response_body_left(const js_http_response_t *r);
+int         js_http_response_skip(js_http_response_t *r, size_t len);
 const char *js_http_response_header(const js_http_response_t *r, const char *name);
 
 #endif /* JS_HTTP_H */
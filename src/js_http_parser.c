@@ -23,6 +23,7 @@ void js_http_response_reset(js_http_response_t *r) {
     r->status_text[0] = '\0';
     r->header_count = 0;
     r->body_len = 0;
+    r->body_skipped = 0;
     r->content_length = 0;
     r->chunked = false;
     r->chunk_remaining = 0;
@@ -160,7 +161,7 @@ static int parse_header_line(js_http_response_t *r) {
 }
 
 static int parse_body_identity(js_http_response_t *r) {
-    size_t remaining = r->content_length - r->body_len;
+    size_t remaining = r->content_length - r->body_len - r->body_skipped;
     size_t avail = r->buf_len < remaining ? r->buf_len : remaining;
 
     if (avail > 0) {
@@ -169,7 +170,7 @@ static int parse_body_identity(js_http_response_t *r) {
         r->buf_len -= avail;
     }
 
-    if (r->body_len >= r->content_length) {
+    if (r->body_len + r->body_skipped >= r->content_length) {
         r->state = HTTP_PARSE_DONE;
         return 1;
     }
@@ -247,6 +248,8 @@ static int parse_chunk_trailer(js_http_response_t *r) {
 }
 
 int js_http_response_feed(js_http_response_t *r, const char *data, size_t len) {
+    js_thread()->counters.parses++;
+
     buf_append(r, data, len);
 
     int progress = 1;
@@ -277,11 +280,51 @@ int js_http_response_feed(js_http_response_t *r, const char *data, size_t len) {
         if (progress < 0) return -1;
     }
 
-    if (r->state == HTTP_PARSE_DONE) return 1;
+    if (r->state == HTTP_PARSE_DONE) {
+        js_thread()->counters.responses++;
+        return 1;
+    }
     if (r->state == HTTP_PARSE_ERROR) return -1;
     return 0;  /* need more data */
 }
 
+/*
+ * Body bytes that can be taken straight off the socket: the rest of an
+ * identity body or of the current chunk, once nothing is buffered.
+ */
+size_t js_http_response_body_left(const js_http_response_t *r) {
+    if (r->buf_len > 0) return 0;
+
+    switch (r->state) {
+        case HTTP_PARSE_BODY_IDENTITY:
+            return r->content_length - r->body_len - r->body_skipped;
+        case HTTP_PARSE_CHUNK_DATA:
+            return r->chunk_remaining;
+        default:
+            return 0;
+    }
+}
+
+/*
+ * Account for len body bytes dropped without being seen.  They are kept
+ * apart from body_len, which is also the append offset into body.
+ */
+int js_http_response_skip(js_http_response_t *r, size_t len) {
+    r->body_skipped += len;
+
+    if (r->state == HTTP_PARSE_BODY_IDENTITY) {
+        if (r->body_len + r->body_skipped >= r->content_length) {
+            r->state = HTTP_PARSE_DONE;
+            js_thread()->counters.responses++;
+            return 1;
+        }
+    } else if (r->state == HTTP_PARSE_CHUNK_DATA) {
+        r->chunk_remaining -= len < r->chunk_remaining ? len : r->chunk_remaining;
+    }
+
+    return 0;
+}
+
 const char *js_http_response_header(const js_http_response_t *r, const char *name) {
     for (int i = 0; i < r->header_count; i++) {
         if (strcasecmp(r->headers[i].name, name) == 0)
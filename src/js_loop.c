@@ -66,15 +66,14 @@ int js_loop_run(js_loop_t *loop, JSRuntime *rt) {
         if (list_empty(&loop->pending)) break;
 
         /* 3. Poll for events and dispatch through handlers */
-        js_msec_t timer_timeout = js_timer_find(&engine->timers);
-        int timeout = (timer_timeout == (js_msec_t) -1)
-                    ? 100 : (int) timer_timeout;
+        js_usec_t timer_timeout = js_timer_find(&engine->timers);
+        int64_t timeout = (timer_timeout == (js_usec_t) -1)
+                        ? 100000 : (int64_t) timer_timeout;
 
         if (js_epoll_poll(engine, timeout) < 0) break;
 
         /* 4. Expire timers */
-        engine->timers.now = (js_msec_t)(js_now_ns() / 1000000);
-        js_timer_expire(&engine->timers, engine->timers.now);
+        js_timer_expire(&engine->timers, js_now_ns() / 1000);
     }
 
     /* Check for unhandled promise rejections */
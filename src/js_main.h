@@ -5,19 +5,26 @@
 #include "js_clang.h"
 #include "js_util.h"
 #include "js_time.h"
-#include "js_rbtree.h"
 #include "js_epoll.h"
 #include "js_timer.h"
 #include "js_engine.h"
 #include "js_thread.h"
 #include "js_buf.h"
 #include "js_tls.h"
+#include "js_body.h"
 #include "js_conn.h"
 #include "js_http.h"
 #include "js_vm.h"
 #include "js_web.h"
+#include "js_template.h"
+#include "js_reqfile.h"
+#include "js_replay.h"
 #include "js_loop.h"
 #include "js_stats.h"
+#include "js_search.h"
+#include "js_tcpinfo.h"
+#include "js_perf.h"
 #include "js_runtime.h"
+#include "js_agent.h"
 
 #endif /* JS_MAIN_H */
@@ -0,0 +1,107 @@
+#include "js_main.h"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+static const struct {
+    uint32_t  type;
+    uint64_t  config;
+} perf_events[JS_PERF_NEVENTS] = {
+    [JS_PERF_CYCLES]           = { PERF_TYPE_HARDWARE,
+                                   PERF_COUNT_HW_CPU_CYCLES },
+    [JS_PERF_INSTRUCTIONS]     = { PERF_TYPE_HARDWARE,
+                                   PERF_COUNT_HW_INSTRUCTIONS },
+    [JS_PERF_CACHE_MISSES]     = { PERF_TYPE_HARDWARE,
+                                   PERF_COUNT_HW_CACHE_MISSES },
+    [JS_PERF_BRANCH_MISSES]    = { PERF_TYPE_HARDWARE,
+                                   PERF_COUNT_HW_BRANCH_MISSES },
+    [JS_PERF_CONTEXT_SWITCHES] = { PERF_TYPE_SOFTWARE,
+                                   PERF_COUNT_SW_CONTEXT_SWITCHES },
+};
+
+/* This thread, on any CPU, counting nothing until enabled */
+static int perf_open_event(js_perf_event_t ev, bool user_only) {
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = perf_events[ev].type;
+    attr.config = perf_events[ev].config;
+    attr.disabled = 1;
+    attr.exclude_hv = 1;
+    attr.exclude_kernel = user_only;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1,
+                         PERF_FLAG_FD_CLOEXEC);
+}
+
+int js_perf_open(js_perf_t *p) {
+    int opened = 0;
+
+    p->opened = 0;
+    p->user_only = false;
+    p->error = 0;
+
+    for (int i = 0; i < JS_PERF_NEVENTS; i++) {
+        p->value[i] = 0;
+        p->fd[i] = perf_open_event(i, p->user_only);
+
+        /* perf_event_paranoid 2: user space only */
+        if (p->fd[i] < 0 && (errno == EACCES || errno == EPERM) &&
+            !p->user_only)
+        {
+            p->user_only = true;
+            p->fd[i] = perf_open_event(i, true);
+        }
+
+        /* Context switches only happen in the kernel: a user count is 0 */
+        if (p->user_only && i == JS_PERF_CONTEXT_SWITCHES && p->fd[i] >= 0) {
+            close(p->fd[i]);
+            p->fd[i] = -1;
+            errno = EACCES;
+        }
+
+        if (p->fd[i] < 0) {
+            if (p->error == 0) p->error = errno;
+            continue;
+        }
+        p->opened |= 1u << i;
+        opened++;
+    }
+
+    return opened;
+}
+
+void js_perf_start(js_perf_t *p) {
+    for (int i = 0; i < JS_PERF_NEVENTS; i++) {
+        if (p->fd[i] < 0) continue;
+        ioctl(p->fd[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(p->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void js_perf_stop(js_perf_t *p) {
+    for (int i = 0; i < JS_PERF_NEVENTS; i++) {
+        uint64_t v[3];   /* value, time enabled, time running */
+
+        if (p->fd[i] < 0) continue;
+        ioctl(p->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+
+        if (read(p->fd[i], v, sizeof(v)) != (ssize_t) sizeof(v)) {
+            p->value[i] = 0;
+            continue;
+        }
+
+        p->value[i] = (v[2] > 0 && v[2] < v[1])
+                    ? (uint64_t) ((double) v[0] * v[1] / v[2]) : v[0];
+    }
+}
+
+void js_perf_close(js_perf_t *p) {
+    for (int i = 0; i < JS_PERF_NEVENTS; i++) {
+        if (p->fd[i] >= 0) close(p->fd[i]);
+        p->fd[i] = -1;
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef JS_PERF_H
+#define JS_PERF_H
+
+/* ── Hardware counters ────────────────────────────────────────────────── */
+
+/*
+ * Self-monitoring perf_event_open() counters on a worker thread.  Each
+ * event is opened on its own, so one the CPU or the kernel refuses (no
+ * PMU in a VM, perf_event_paranoid) is left out instead of failing the
+ * set.  Counts are scaled up when the kernel had to multiplex them.
+ */
+
+typedef enum {
+    JS_PERF_CYCLES,
+    JS_PERF_INSTRUCTIONS,
+    JS_PERF_CACHE_MISSES,
+    JS_PERF_BRANCH_MISSES,
+    JS_PERF_CONTEXT_SWITCHES,
+    JS_PERF_NEVENTS
+} js_perf_event_t;
+
+typedef struct {
+    int       fd[JS_PERF_NEVENTS];      /* -1: not available */
+    uint64_t  value[JS_PERF_NEVENTS];
+    uint32_t  opened;                   /* bit per event counted */
+    bool      user_only;                /* kernel time was not allowed */
+    int       error;                    /* errno of the first refusal */
+} js_perf_t;
+
+int  js_perf_open(js_perf_t *p);        /* events opened, 0: none */
+void js_perf_start(js_perf_t *p);       /* reset and enable */
+void js_perf_stop(js_perf_t *p);        /* disable and read */
+void js_perf_close(js_perf_t *p);
+
+#endif /* JS_PERF_H */
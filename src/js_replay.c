@@ -0,0 +1,359 @@
+#include "js_main.h"
+
+typedef struct {
+    double  t;              /* absolute time in seconds */
+    int     seq;            /* original order, keeps the sort stable */
+    size_t  off;
+    size_t  len;
+} replay_item_t;
+
+typedef struct {
+    js_replay_t     *rp;
+    replay_item_t   *items;
+    int              cap;
+    const js_url_t  *base;
+    const char      *host;
+} replay_builder_t;
+
+/* ── Building ─────────────────────────────────────────────────────────── */
+
+static int replay_add(replay_builder_t *b, double t, const char *method,
+                      const char *path, const char *headers,
+                      const char *body, size_t body_len) {
+    js_replay_t *rp = b->rp;
+
+    if (rp->count == b->cap) {
+        int ncap = b->cap ? b->cap * 2 : 1024;
+        replay_item_t *items = realloc(b->items,
+                                       sizeof(replay_item_t) * (size_t)ncap);
+        if (!items) return -1;
+        b->items = items;
+        b->cap = ncap;
+    }
+
+    js_request_t req = {
+        .url = *b->base,
+        .method = (char *)method,
+        .headers = (char *)headers,
+        .body = (char *)body,
+        .body_len = body_len,
+    };
+
+    size_t plen = strlen(path);
+    if (plen >= sizeof(req.url.path)) return -1;
+    memcpy(req.url.path, path, plen + 1);
+
+    js_buf_t one = {0};
+    if (js_request_serialize(&req, b->host, &one) != 0) return -1;
+
+    js_buf_t *data = &rp->data;
+    if (js_buf_ensure(data, data->len + one.len) < 0) {
+        js_buf_free(&one);
+        return -1;
+    }
+    memcpy(data->data + data->len, one.data, one.len);
+
+    replay_item_t *it = &b->items[rp->count];
+    it->t = t;
+    it->seq = rp->count;
+    it->off = data->len;
+    it->len = one.len;
+
+    data->len += one.len;
+    rp->count++;
+
+    js_buf_free(&one);
+    return 0;
+}
+
+static int replay_item_cmp(const void *a, const void *b) {
+    const replay_item_t *x = a, *y = b;
+
+    if (x->t != y->t) return x->t < y->t ? -1 : 1;
+    return x->seq - y->seq;
+}
+
+/*
+ * Sort by time and convert to scaled offsets.  With whole-second
+ * timestamps, requests logged in the same second are spread evenly over
+ * it rather than fired as one burst.
+ */
+static int replay_finish(replay_builder_t *b, bool whole_seconds,
+                         double speedup) {
+    js_replay_t *rp = b->rp;
+
+    qsort(b->items, (size_t)rp->count, sizeof(replay_item_t), replay_item_cmp);
+
+    rp->entries = malloc(sizeof(js_replay_entry_t) * (size_t)rp->count);
+    if (!rp->entries) return -1;
+
+    double t0 = b->items[0].t;
+
+    for (int i = 0; i < rp->count; ) {
+        int n = 1;
+        if (whole_seconds) {
+            while (i + n < rp->count && b->items[i + n].t == b->items[i].t) n++;
+        }
+
+        for (int k = 0; k < n; k++) {
+            replay_item_t *it = &b->items[i + k];
+            double at = it->t - t0 + (double)k / n;
+
+            rp->entries[i + k].at_us = (uint64_t)(at * 1e6 / speedup);
+            rp->entries[i + k].off = it->off;
+            rp->entries[i + k].len = it->len;
+        }
+        i += n;
+    }
+
+    return 0;
+}
+
+/* ── nginx access log ─────────────────────────────────────────────────── */
+
+/*
+ *   127.0.0.1 - - [10/Oct/2000:13:55:36 -0700] "GET /a.gif HTTP/1.1" 200 ...
+ */
+static int replay_parse_nginx_line(replay_builder_t *b, char *line) {
+    char *lb = strchr(line, '[');
+    char *rb = lb ? strchr(lb, ']') : NULL;
+    if (!rb) return -1;
+
+    struct tm tm = {0};
+    *rb = '\0';
+    if (!strptime(lb + 1, "%d/%b/%Y:%H:%M:%S %z", &tm)) return -1;
+
+    /* timegm() normalises tm and clears tm_gmtoff */
+    long off = tm.tm_gmtoff;
+    double t = (double)(timegm(&tm) - off);
+
+    char *q1 = strchr(rb + 1, '"');
+    char *q2 = q1 ? strchr(q1 + 1, '"') : NULL;
+    if (!q2) return -1;
+    *q2 = '\0';
+
+    char *method = q1 + 1;
+    char *path = strchr(method, ' ');
+    if (!path) return -1;
+    *path++ = '\0';
+
+    char *proto = strchr(path, ' ');
+    if (proto) *proto = '\0';
+    if (path[0] != '/') return -1;
+
+    return replay_add(b, t, method, path, NULL, NULL, 0);
+}
+
+static int replay_load_nginx(replay_builder_t *b, char *text) {
+    char *save = NULL;
+
+    for (char *line = strtok_r(text, "\n", &save); line;
+         line = strtok_r(NULL, "\n", &save))
+    {
+        if (replay_parse_nginx_line(b, line) != 0) b->rp->skipped++;
+    }
+
+    return 0;
+}
+
+/* ── HAR ──────────────────────────────────────────────────────────────── */
+
+/* ISO 8601: 2024-05-01T12:00:00.123Z or with a +hh:mm offset */
+static int replay_parse_iso8601(const char *s, double *t) {
+    struct tm tm = {0};
+    const char *p = strptime(s, "%Y-%m-%dT%H:%M:%S", &tm);
+    if (!p) return -1;
+
+    double frac = 0;
+    if (*p == '.') {
+        char *end;
+        frac = strtod(p, &end);
+        p = end;
+    }
+
+    long off = 0;
+    if (*p == '+' || *p == '-') {
+        int hh = 0, mm = 0;
+        sscanf(p + 1, "%2d:%2d", &hh, &mm);
+        off = (hh * 3600 + mm * 60) * (*p == '-' ? -1 : 1);
+    }
+
+    *t = (double)(timegm(&tm) - off) + frac;
+    return 0;
+}
+
+static char *replay_get_string(JSContext *ctx, JSValueConst obj,
+                               const char *name) {
+    JSValue v = JS_GetPropertyStr(ctx, obj, name);
+    char *ret = NULL;
+
+    if (JS_IsString(v)) {
+        const char *s = JS_ToCString(ctx, v);
+        if (s) {
+            ret = strdup(s);
+            JS_FreeCString(ctx, s);
+        }
+    }
+    JS_FreeValue(ctx, v);
+    return ret;
+}
+
+/* Headers jsb writes itself, or that only make sense in HTTP/2 */
+static bool replay_skip_header(const char *name) {
+    return name[0] == ':' ||
+           strcasecmp(name, "Host") == 0 ||
+           strcasecmp(name, "Connection") == 0 ||
+           strcasecmp(name, "Content-Length") == 0;
+}
+
+static int replay_parse_har_entry(replay_builder_t *b, JSContext *ctx,
+                                  JSValueConst entry) {
+    JSValue req = JS_GetPropertyStr(ctx, entry, "request");
+    JSValue hdrs = JS_GetPropertyStr(ctx, req, "headers");
+    JSValue post = JS_GetPropertyStr(ctx, req, "postData");
+    char *started = replay_get_string(ctx, entry, "startedDateTime");
+    char *method = replay_get_string(ctx, req, "method");
+    char *url = replay_get_string(ctx, req, "url");
+    char *body = JS_IsObject(post) ? replay_get_string(ctx, post, "text") : NULL;
+    js_buf_t headers = {0};
+    int rc = -1;
+    double t;
+    js_url_t u;
+
+    if (!started || !method || !url) goto done;
+    if (replay_parse_iso8601(started, &t) != 0) goto done;
+    if (js_parse_url(url, &u) != 0) goto done;
+
+    if (JS_IsArray(ctx, hdrs)) {
+        JSValue len_val = JS_GetPropertyStr(ctx, hdrs, "length");
+        int32_t len = 0;
+        int err = 0;
+        JS_ToInt32(ctx, &len, len_val);
+        JS_FreeValue(ctx, len_val);
+
+        for (int32_t i = 0; i < len && !err; i++) {
+            JSValue h = JS_GetPropertyUint32(ctx, hdrs, (uint32_t)i);
+            char *name = replay_get_string(ctx, h, "name");
+            char *value = replay_get_string(ctx, h, "value");
+
+            if (name && value && !replay_skip_header(name)) {
+                /* "name: value\r\n" and the terminating NUL */
+                size_t need = strlen(name) + strlen(value) + 5;
+
+                if (js_buf_ensure(&headers, headers.len + need) < 0) {
+                    err = -1;
+                } else {
+                    headers.len += (size_t)sprintf(headers.data + headers.len,
+                                                   "%s: %s\r\n", name, value);
+                }
+            }
+
+            free(name);
+            free(value);
+            JS_FreeValue(ctx, h);
+        }
+
+        if (err) goto done;
+    }
+
+    rc = replay_add(b, t, method, u.path, headers.len ? headers.data : NULL,
+                    body, body ? strlen(body) : 0);
+
+done:
+    js_buf_free(&headers);
+    free(started);
+    free(method);
+    free(url);
+    free(body);
+    JS_FreeValue(ctx, post);
+    JS_FreeValue(ctx, hdrs);
+    JS_FreeValue(ctx, req);
+    return rc;
+}
+
+static int replay_load_har(replay_builder_t *b, JSContext *ctx,
+                           const char *text, size_t len, const char *path) {
+    JSValue har = JS_ParseJSON(ctx, text, len, path);
+    if (JS_IsException(har)) {
+        JS_FreeValue(ctx, JS_GetException(ctx));
+        return -1;
+    }
+
+    JSValue log = JS_GetPropertyStr(ctx, har, "log");
+    JSValue entries = JS_GetPropertyStr(ctx, log, "entries");
+    int rc = -1;
+
+    if (JS_IsArray(ctx, entries)) {
+        JSValue len_val = JS_GetPropertyStr(ctx, entries, "length");
+        int32_t n = 0;
+        JS_ToInt32(ctx, &n, len_val);
+        JS_FreeValue(ctx, len_val);
+
+        for (int32_t i = 0; i < n; i++) {
+            JSValue e = JS_GetPropertyUint32(ctx, entries, (uint32_t)i);
+            if (replay_parse_har_entry(b, ctx, e) != 0) b->rp->skipped++;
+            JS_FreeValue(ctx, e);
+        }
+        rc = 0;
+    }
+
+    JS_FreeValue(ctx, entries);
+    JS_FreeValue(ctx, log);
+    JS_FreeValue(ctx, har);
+    return rc;
+}
+
+/* ── Public API ───────────────────────────────────────────────────────── */
+
+js_replay_t *js_replay_load(JSContext *ctx, const char *path,
+                            const char *format, const js_url_t *base,
+                            const char *host, double speedup) {
+    size_t len;
+    char *text = js_read_file(path, &len);
+    if (!text) return NULL;
+
+    if (!format) {
+        const char *ext = strrchr(path, '.');
+        format = (ext && strcasecmp(ext, ".har") == 0) ? "har" : "nginx";
+    }
+
+    js_replay_t *rp = calloc(1, sizeof(js_replay_t));
+    if (!rp) {
+        free(text);
+        return NULL;
+    }
+
+    replay_builder_t b = { .rp = rp, .base = base, .host = host };
+    bool whole_seconds = false;
+    int rc;
+
+    if (strcasecmp(format, "har") == 0) {
+        rc = replay_load_har(&b, ctx, text, len, path);
+    } else if (strcasecmp(format, "nginx") == 0) {
+        rc = replay_load_nginx(&b, text);
+        whole_seconds = true;
+    } else {
+        rc = -1;
+    }
+
+    free(text);
+
+    if (rc != 0 || rp->count == 0 ||
+        replay_finish(&b, whole_seconds, speedup > 0 ? speedup : 1.0) != 0)
+    {
+        free(b.items);
+        js_replay_free(rp);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    free(b.items);
+    return rp;
+}
+
+void js_replay_free(js_replay_t *rp) {
+    if (!rp) return;
+    js_buf_free(&rp->data);
+    free(rp->entries);
+    free(rp);
+}
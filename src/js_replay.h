@@ -0,0 +1,30 @@
+#ifndef JS_REPLAY_H
+#define JS_REPLAY_H
+
+/* ── Replay schedule ──────────────────────────────────────────────────── */
+
+/*
+ * Requests recovered from an nginx access log (combined or common format)
+ * or a HAR file, each with its offset from the first request.  Requests
+ * are serialized back to back into one buffer.
+ */
+
+typedef struct {
+    uint64_t  at_us;        /* offset from the start, already scaled */
+    size_t    off;          /* serialized request in data */
+    size_t    len;
+} js_replay_entry_t;
+
+typedef struct {
+    js_buf_t            data;
+    js_replay_entry_t  *entries;
+    int                 count;
+    int                 skipped;      /* lines that could not be parsed */
+} js_replay_t;
+
+js_replay_t *js_replay_load(JSContext *ctx, const char *path,
+                            const char *format, const js_url_t *base,
+                            const char *host, double speedup);
+void         js_replay_free(js_replay_t *rp);
+
+#endif /* JS_REPLAY_H */
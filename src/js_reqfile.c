@@ -0,0 +1,560 @@
+#include "js_main.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* ── Indexing ─────────────────────────────────────────────────────────── */
+
+static int reqfile_add(js_reqfile_t *f, int *cap, size_t off, size_t len) {
+    if (f->count == *cap) {
+        if (*cap >= INT_MAX / 2) return -1;
+        int ncap = *cap ? *cap * 2 : 1024;
+        js_reqfile_rec_t *recs = realloc(f->recs,
+                                         sizeof(js_reqfile_rec_t) * (size_t)ncap);
+        if (!recs) return -1;
+        f->recs = recs;
+        *cap = ncap;
+    }
+
+    f->recs[f->count].off = off;
+    f->recs[f->count].len = len;
+    f->count++;
+    return 0;
+}
+
+/* A CSV header names only the url, method and body columns */
+static bool reqfile_csv_header(const char *p, const char *end) {
+    bool url = false;
+
+    while (p < end) {
+        const char *q = memchr(p, ',', (size_t)(end - p));
+        size_t n = (size_t)((q ? q : end) - p);
+
+        if (n == 3 && strncasecmp(p, "url", 3) == 0) url = true;
+        else if (!(n == 6 && strncasecmp(p, "method", 6) == 0) &&
+                 !(n == 4 && strncasecmp(p, "body", 4) == 0))
+            return false;
+
+        p = q ? q + 1 : end;
+    }
+
+    return url;
+}
+
+/* One record per non-empty line; a CSV header line is skipped */
+static int reqfile_index_lines(js_reqfile_t *f) {
+    const char *p = f->data;
+    const char *end = f->data + f->size;
+    int cap = 0;
+
+    while (p < end) {
+        const char *nl = memchr(p, '\n', (size_t)(end - p));
+        const char *eol = nl ? nl : end;
+        const char *le = eol;
+
+        if (le > p && le[-1] == '\r') le--;
+
+        bool header = f->format == JS_REQFILE_CSV && p == f->data &&
+                      reqfile_csv_header(p, le);
+
+        if (le > p && !header) {
+            if (reqfile_add(f, &cap, (size_t)(p - f->data),
+                            (size_t)(le - p)) != 0)
+                return -1;
+        }
+
+        p = nl ? nl + 1 : end;
+    }
+
+    return 0;
+}
+
+/* Concatenated raw requests; each ends after its Content-Length body */
+static int reqfile_index_http(js_reqfile_t *f) {
+    const char *p = f->data;
+    const char *end = f->data + f->size;
+    int cap = 0;
+
+    for (;;) {
+        while (p < end && (*p == '\r' || *p == '\n')) p++;
+        if (p == end) return 0;
+
+        const char *hdr_end = memmem(p, (size_t)(end - p), "\r\n\r\n", 4);
+        if (!hdr_end) return -1;
+        hdr_end += 4;
+
+        size_t body_len = 0;
+        const char *h = p;
+        while ((h = memmem(h, (size_t)(hdr_end - h), "\r\n", 2)) && h < hdr_end - 2) {
+            h += 2;
+            if (strncasecmp(h, "Content-Length:", 15) == 0) {
+                body_len = (size_t)strtoul(h + 15, NULL, 10);
+            }
+        }
+
+        if (body_len > (size_t)(end - hdr_end)) return -1;
+
+        if (reqfile_add(f, &cap, (size_t)(p - f->data),
+                        (size_t)(hdr_end - p) + body_len) != 0)
+            return -1;
+
+        p = hdr_end + body_len;
+    }
+}
+
+static int reqfile_format(const char *path, const char *format,
+                          js_reqfile_format_t *out) {
+    const char *ext = format;
+
+    if (!ext) {
+        ext = strrchr(path, '.');
+        ext = ext ? ext + 1 : "";
+    }
+
+    if (strcasecmp(ext, "ndjson") == 0 || strcasecmp(ext, "jsonl") == 0) {
+        *out = JS_REQFILE_NDJSON;
+    } else if (strcasecmp(ext, "csv") == 0) {
+        *out = JS_REQFILE_CSV;
+    } else if (strcasecmp(ext, "http") == 0) {
+        *out = JS_REQFILE_HTTP;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+js_reqfile_t *js_reqfile_open(const char *path, const char *format) {
+    js_reqfile_t *f = calloc(1, sizeof(js_reqfile_t));
+    if (!f) return NULL;
+
+    if (reqfile_format(path, format, &f->format) != 0) {
+        free(f);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        free(f);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        free(f);
+        return NULL;
+    }
+
+    if (st.st_size == 0) {
+        close(fd);
+        free(f);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        free(f);
+        return NULL;
+    }
+
+    f->data = data;
+    f->size = (size_t)st.st_size;
+
+    int rc = f->format == JS_REQFILE_HTTP ? reqfile_index_http(f)
+                                          : reqfile_index_lines(f);
+    if (rc != 0 || f->count == 0) {
+        js_reqfile_close(f);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    return f;
+}
+
+void js_reqfile_close(js_reqfile_t *f) {
+    if (!f) return;
+    if (f->data) munmap((void *) f->data, f->size);
+    free(f->recs);
+    free(f);
+}
+
+void js_reqfile_set_host(js_reqfile_t *f, const js_url_t *url,
+                         const char *host_override) {
+    bool need_port = (url->is_tls && url->port != 443) ||
+                     (!url->is_tls && url->port != 80);
+
+    if (host_override)
+        snprintf(f->host_line, sizeof(f->host_line), "Host: %s\r\n", host_override);
+    else if (need_port)
+        snprintf(f->host_line, sizeof(f->host_line), "Host: %s:%d\r\n",
+                 url->host, url->port);
+    else
+        snprintf(f->host_line, sizeof(f->host_line), "Host: %s\r\n", url->host);
+}
+
+/* ── Field decoding ───────────────────────────────────────────────────── */
+
+typedef struct {
+    const char  *p;
+    size_t       len;
+    bool         escaped;    /* JSON escapes or CSV "" quoting */
+} reqfile_str_t;
+
+static char *reqfile_utf8(char *dst, unsigned cp) {
+    if (cp < 0x80) {
+        *dst++ = (char) cp;
+    } else if (cp < 0x800) {
+        *dst++ = (char) (0xc0 | (cp >> 6));
+        *dst++ = (char) (0x80 | (cp & 0x3f));
+    } else if (cp < 0x10000) {
+        *dst++ = (char) (0xe0 | (cp >> 12));
+        *dst++ = (char) (0x80 | ((cp >> 6) & 0x3f));
+        *dst++ = (char) (0x80 | (cp & 0x3f));
+    } else {
+        *dst++ = (char) (0xf0 | (cp >> 18));
+        *dst++ = (char) (0x80 | ((cp >> 12) & 0x3f));
+        *dst++ = (char) (0x80 | ((cp >> 6) & 0x3f));
+        *dst++ = (char) (0x80 | (cp & 0x3f));
+    }
+    return dst;
+}
+
+static unsigned reqfile_hex4(const char *p) {
+    char tmp[5] = { p[0], p[1], p[2], p[3], '\0' };
+    return (unsigned) strtoul(tmp, NULL, 16);
+}
+
+/*
+ * Decode the body of a JSON string (without quotes) into dst, or only
+ * measure it when dst is NULL.  Decoding never grows the text.
+ */
+static size_t reqfile_json_unescape(reqfile_str_t s, char *dst) {
+    const char *p = s.p, *end = s.p + s.len;
+    char buf[4];
+    size_t n = 0;
+
+    while (p < end) {
+        char *o = dst ? dst : buf;
+        char *e = o;
+
+        if (*p != '\\' || p + 1 >= end) {
+            *e++ = *p++;
+        } else {
+            p++;
+            switch (*p) {
+                case 'n': *e++ = '\n'; p++; break;
+                case 'r': *e++ = '\r'; p++; break;
+                case 't': *e++ = '\t'; p++; break;
+                case 'b': *e++ = '\b'; p++; break;
+                case 'f': *e++ = '\f'; p++; break;
+                case 'u': {
+                    if (end - p < 5) { p = end; break; }
+                    unsigned cp = reqfile_hex4(p + 1);
+                    p += 5;
+                    if (cp >= 0xd800 && cp < 0xdc00 && end - p >= 6 &&
+                        p[0] == '\\' && p[1] == 'u')
+                    {
+                        unsigned lo = reqfile_hex4(p + 2);
+                        cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+                        p += 6;
+                    }
+                    e = reqfile_utf8(e, cp);
+                    break;
+                }
+                default:  *e++ = *p++; break;    /* \" \\ \/ */
+            }
+        }
+
+        n += (size_t)(e - o);
+        if (dst) dst = e;
+    }
+
+    return n;
+}
+
+/*
+ * Skip a JSON value starting at p; returns the position after it, or NULL
+ * if a string runs past the end of the record
+ */
+static const char *reqfile_json_skip(const char *p, const char *end) {
+    int depth = 0;
+
+    do {
+        if (p >= end) return end;
+
+        if (*p == '"') {
+            for (p++; p < end && *p != '"'; p++) {
+                if (*p == '\\' && ++p == end) return NULL;
+            }
+            if (p == end) return NULL;
+            p++;
+        } else if (*p == '{' || *p == '[') {
+            depth++;
+            p++;
+        } else if (*p == '}' || *p == ']') {
+            depth--;
+            p++;
+        } else if (depth == 0) {
+            while (p < end && *p != ',' && *p != '}' && *p != ']') p++;
+        } else {
+            p++;
+        }
+    } while (depth > 0);
+
+    return p;
+}
+
+static const char *reqfile_json_ws(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+
+/* Read a JSON string at p into s; returns the position after it */
+static const char *reqfile_json_string(const char *p, const char *end,
+                                       reqfile_str_t *s) {
+    if (p >= end || *p != '"') return NULL;
+
+    const char *q = reqfile_json_skip(p, end);
+    if (!q) return NULL;
+    s->p = p + 1;
+    s->len = (size_t)(q - p) - 2;
+    s->escaped = true;
+    return q;
+}
+
+/* ── Rendering ────────────────────────────────────────────────────────── */
+
+typedef struct {
+    reqfile_str_t  method;
+    reqfile_str_t  url;
+    reqfile_str_t  body;
+    reqfile_str_t  headers;     /* JSON object text */
+    bool           json;
+} reqfile_fields_t;
+
+static int reqfile_parse_ndjson(const char *p, const char *end,
+                                reqfile_fields_t *fl) {
+    p = reqfile_json_ws(p, end);
+
+    if (p < end && *p == '"')
+        return reqfile_json_string(p, end, &fl->url) ? 0 : -1;
+
+    if (p >= end || *p != '{') return -1;
+    p++;
+
+    while (p < end) {
+        reqfile_str_t key;
+
+        p = reqfile_json_ws(p, end);
+        if (p < end && *p == '}') break;
+
+        p = reqfile_json_string(p, end, &key);
+        if (!p) return -1;
+        p = reqfile_json_ws(p, end);
+        if (p >= end || *p != ':') return -1;
+        p = reqfile_json_ws(p + 1, end);
+
+        const char *v = p;
+        p = reqfile_json_skip(p, end);
+        if (!p) return -1;
+
+        reqfile_str_t *dst = NULL;
+        if (key.len == 3 && memcmp(key.p, "url", 3) == 0) dst = &fl->url;
+        else if (key.len == 6 && memcmp(key.p, "method", 6) == 0) dst = &fl->method;
+        else if (key.len == 4 && memcmp(key.p, "body", 4) == 0) dst = &fl->body;
+
+        if (dst && *v == '"') {
+            reqfile_json_string(v, end, dst);
+        } else if (key.len == 7 && memcmp(key.p, "headers", 7) == 0 && *v == '{') {
+            fl->headers.p = v;
+            fl->headers.len = (size_t)(p - v);
+        }
+
+        p = reqfile_json_ws(p, end);
+        if (p < end && *p == ',') p++;
+    }
+
+    return fl->url.p ? 0 : -1;
+}
+
+/* Split one CSV field; returns the start of the next one, or NULL */
+static const char *reqfile_csv_field(const char *p, const char *end,
+                                     reqfile_str_t *s) {
+    s->escaped = p < end && *p == '"';
+
+    if (s->escaped) {
+        const char *q = p + 1;
+        while (q < end) {
+            if (*q == '"') {
+                if (q + 1 < end && q[1] == '"') { q += 2; continue; }
+                break;
+            }
+            q++;
+        }
+        s->p = p + 1;
+        s->len = (size_t)(q - p - 1);
+        p = q < end ? q + 1 : end;
+    } else {
+        const char *q = memchr(p, ',', (size_t)(end - p));
+        s->p = p;
+        s->len = (size_t)((q ? q : end) - p);
+        p = q ? q : end;
+    }
+
+    return (p < end && *p == ',') ? p + 1 : NULL;
+}
+
+static size_t reqfile_csv_unquote(reqfile_str_t s, char *dst) {
+    size_t n = 0;
+
+    for (size_t i = 0; i < s.len; i++) {
+        if (s.p[i] == '"' && i + 1 < s.len && s.p[i + 1] == '"') i++;
+        if (dst) dst[n] = s.p[i];
+        n++;
+    }
+    return n;
+}
+
+static int reqfile_parse_csv(const char *p, const char *end,
+                             reqfile_fields_t *fl) {
+    reqfile_str_t first;
+
+    p = reqfile_csv_field(p, end, &first);
+    if (!p) {
+        fl->url = first;
+        return 0;
+    }
+
+    fl->method = first;
+    p = reqfile_csv_field(p, end, &fl->url);
+    if (!p) return 0;
+
+    /* An unquoted body runs to the end of the line, commas included */
+    if (*p == '"') {
+        reqfile_csv_field(p, end, &fl->body);
+    } else {
+        fl->body.p = p;
+        fl->body.len = (size_t)(end - p);
+    }
+    return 0;
+}
+
+static size_t reqfile_decode(const reqfile_fields_t *fl, reqfile_str_t s,
+                             char *dst) {
+    if (!s.escaped) {
+        if (dst) memcpy(dst, s.p, s.len);
+        return s.len;
+    }
+    if (fl->json) return reqfile_json_unescape(s, dst);
+    return reqfile_csv_unquote(s, dst);
+}
+
+/* Write the path of a URL (absolute URLs lose their scheme and host) */
+static char *reqfile_put_path(const reqfile_fields_t *fl, char *p) {
+    size_t n = reqfile_decode(fl, fl->url, p);
+    char *path = p;
+
+    if (n > 8 && (memcmp(p, "http://", 7) == 0 || memcmp(p, "https://", 8) == 0)) {
+        char *host = memchr(p, ':', n) + 3;
+        path = memchr(host, '/', (size_t)(p + n - host));
+        if (!path) {
+            *p = '/';
+            return p + 1;
+        }
+        n -= (size_t)(path - p);
+        memmove(p, path, n);
+    } else if (n == 0) {
+        *p = '/';
+        return p + 1;
+    }
+
+    return p + n;
+}
+
+static char *reqfile_put_headers(const reqfile_fields_t *fl, char *o) {
+    const char *p = fl->headers.p + 1;
+    const char *end = fl->headers.p + fl->headers.len - 1;
+
+    while (p < end) {
+        reqfile_str_t k, v;
+
+        p = reqfile_json_ws(p, end);
+        if (p >= end || !(p = reqfile_json_string(p, end, &k))) break;
+        p = reqfile_json_ws(p, end);
+        if (p >= end || *p != ':') break;
+        p = reqfile_json_ws(p + 1, end);
+        if (!(p = reqfile_json_string(p, end, &v))) break;
+
+        o += reqfile_json_unescape(k, o);
+        *o++ = ':';
+        *o++ = ' ';
+        o += reqfile_json_unescape(v, o);
+        *o++ = '\r';
+        *o++ = '\n';
+
+        p = reqfile_json_ws(p, end);
+        if (p < end && *p == ',') p++;
+    }
+
+    return o;
+}
+
+int js_reqfile_render(const js_reqfile_t *f, int idx, js_buf_t *out) {
+    const js_reqfile_rec_t *rec = &f->recs[idx];
+    const char *p = f->data + rec->off;
+    const char *end = p + rec->len;
+
+    if (f->format == JS_REQFILE_HTTP) {
+        if (js_buf_ensure(out, rec->len) < 0) return -1;
+        memcpy(out->data, p, rec->len);
+        out->len = rec->len;
+        out->pos = 0;
+        return 0;
+    }
+
+    reqfile_fields_t fl = { .json = f->format == JS_REQFILE_NDJSON };
+    int rc = fl.json ? reqfile_parse_ndjson(p, end, &fl)
+                     : reqfile_parse_csv(p, end, &fl);
+    if (rc != 0) return -1;
+
+    /* Decoding never grows a field, so the record length bounds it all */
+    if (js_buf_ensure(out, rec->len + sizeof(f->host_line) + 128) < 0)
+        return -1;
+
+    char *o = out->data;
+
+    if (fl.method.len) {
+        o += reqfile_decode(&fl, fl.method, o);
+    } else {
+        memcpy(o, "GET", 3);
+        o += 3;
+    }
+    *o++ = ' ';
+    o = reqfile_put_path(&fl, o);
+    memcpy(o, " HTTP/1.1\r\n", 11);
+    o += 11;
+
+    size_t hlen = strlen(f->host_line);
+    memcpy(o, f->host_line, hlen);
+    o += hlen;
+
+    if (fl.headers.p) o = reqfile_put_headers(&fl, o);
+
+    memcpy(o, "Connection: keep-alive\r\n", 24);
+    o += 24;
+
+    if (fl.body.len) {
+        size_t blen = reqfile_decode(&fl, fl.body, NULL);
+        o += sprintf(o, "Content-Length: %zu\r\n\r\n", blen);
+        o += reqfile_decode(&fl, fl.body, o);
+    } else {
+        *o++ = '\r';
+        *o++ = '\n';
+    }
+
+    out->len = (size_t)(o - out->data);
+    out->pos = 0;
+    return 0;
+}
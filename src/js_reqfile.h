@@ -0,0 +1,44 @@
+#ifndef JS_REQFILE_H
+#define JS_REQFILE_H
+
+/* ── Request file ─────────────────────────────────────────────────────── */
+
+/*
+ * A file of requests mapped read-only into memory and shared by all
+ * workers.  Only an index of record offsets is built at load time; each
+ * record is turned into an HTTP request when a worker sends it.
+ *
+ *   ndjson  one JSON object per line: { url, method, headers, body },
+ *           or a JSON string holding the URL
+ *   csv     url | method,url | method,url,body  (RFC 4180 quoting)
+ *   http    raw HTTP/1.1 requests, sent as they are
+ */
+
+typedef enum {
+    JS_REQFILE_NDJSON,
+    JS_REQFILE_CSV,
+    JS_REQFILE_HTTP
+} js_reqfile_format_t;
+
+typedef struct {
+    size_t  off;
+    size_t  len;
+} js_reqfile_rec_t;
+
+typedef struct {
+    js_reqfile_format_t  format;
+    const char          *data;       /* mmap()ed file */
+    size_t               size;
+    js_reqfile_rec_t    *recs;
+    int                  count;
+    char                 host_line[300];   /* "Host: ...\r\n" */
+} js_reqfile_t;
+
+js_reqfile_t *js_reqfile_open(const char *path, const char *format);
+void          js_reqfile_close(js_reqfile_t *f);
+void          js_reqfile_set_host(js_reqfile_t *f, const js_url_t *url,
+                                  const char *host_override);
+int           js_reqfile_render(const js_reqfile_t *f, int idx,
+                                js_buf_t *out);
+
+#endif /* JS_REQFILE_H */
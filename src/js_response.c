@@ -5,7 +5,9 @@ typedef struct {
     char        *status_text;
     char        *body;
     size_t       body_len;
-    JSValue      headers_obj;  /* JS Headers object */
+    js_buf_t     headers_raw;  /* packed "name\0value\0" pairs */
+    int          header_count;
+    JSValue      headers_obj;  /* JS Headers object, built on first access */
     bool         body_used;
 } js_response_t;
 
@@ -16,6 +18,7 @@ static void js_response_finalizer(JSRuntime *rt, JSValue val) {
     if (r) {
         free(r->status_text);
         free(r->body);
+        js_buf_free(&r->headers_raw);
         JS_FreeValueRT(rt, r->headers_obj);
         js_free_rt(rt, r);
     }
@@ -50,6 +53,13 @@ static JSValue js_response_get_status_text(JSContext *ctx, JSValueConst this_val
 static JSValue js_response_get_headers(JSContext *ctx, JSValueConst this_val) {
     js_response_t *r = JS_GetOpaque(this_val, js_response_class_id);
     if (!r) return JS_UNDEFINED;
+
+    if (JS_IsUndefined(r->headers_obj)) {
+        r->headers_obj = js_headers_from_packed(ctx, r->headers_raw.data,
+                                                r->header_count);
+        js_buf_free(&r->headers_raw);
+    }
+
     return JS_DupValue(ctx, r->headers_obj);
 }
 
@@ -115,7 +125,9 @@ JSValue js_response_new(JSContext *ctx, int status, const char *status_text,
         r->body_len = 0;
     }
 
-    r->headers_obj = js_headers_from_http(ctx, parsed);
+    r->headers_obj = JS_UNDEFINED;
+    if (parsed && js_headers_pack(parsed, &r->headers_raw) == 0)
+        r->header_count = parsed->header_count;
 
     JSValue obj = JS_NewObjectClass(ctx, (int)js_response_class_id);
     JS_SetOpaque(obj, r);
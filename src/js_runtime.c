@@ -1,4 +1,8 @@
 #include "js_main.h"
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <sys/resource.h>
 
 /* ── Detect mode from default export ──────────────────────────────────── */
 
@@ -24,6 +28,180 @@ js_mode_t js_runtime_detect_mode(JSContext *ctx, JSValue default_export) {
 
 /* ── Extract bench config ─────────────────────────────────────────────── */
 
+/* { p99, errorRate, step, start, max }: all optional */
+static js_search_t *extract_search(JSContext *ctx, JSValue val) {
+    js_search_t *s = calloc(1, sizeof(js_search_t));
+    if (!s) return NULL;
+
+    s->p99_us = 100000;
+    s->error_rate = 0.001;
+    s->step_sec = 5;
+    s->start_rate = 100;
+    s->max_rate = 10000000;
+    atomic_init(&s->step, 0);
+
+    JSValue v;
+
+    v = JS_GetPropertyStr(ctx, val, "p99");
+    if (JS_IsString(v)) {
+        const char *str = JS_ToCString(ctx, v);
+        if (str) {
+            s->p99_us = js_parse_duration(str) * 1e6;
+            JS_FreeCString(ctx, str);
+        }
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, val, "step");
+    if (JS_IsString(v)) {
+        const char *str = JS_ToCString(ctx, v);
+        if (str) {
+            double sec = js_parse_duration(str);
+            if (sec > 0) s->step_sec = sec;
+            JS_FreeCString(ctx, str);
+        }
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, val, "errorRate");
+    if (JS_IsNumber(v)) JS_ToFloat64(ctx, &s->error_rate, v);
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, val, "start");
+    if (JS_IsNumber(v)) JS_ToFloat64(ctx, &s->start_rate, v);
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, val, "max");
+    if (JS_IsNumber(v)) JS_ToFloat64(ctx, &s->max_rate, v);
+    JS_FreeValue(ctx, v);
+
+    if (s->start_rate < 1) s->start_rate = 1;
+    if (s->max_rate < s->start_rate) s->max_rate = s->start_rate;
+
+    return s;
+}
+
+/* A byte count: a number, or a string such as '4MB' */
+static int extract_size(JSContext *ctx, JSValue v) {
+    if (JS_IsNumber(v)) {
+        int32_t n;
+        JS_ToInt32(ctx, &n, v);
+        return n > 0 ? n : 0;
+    }
+
+    if (JS_IsString(v)) {
+        const char *s = JS_ToCString(ctx, v);
+        uint64_t n = js_parse_size(s);
+        if (s) JS_FreeCString(ctx, s);
+        return n < INT_MAX ? (int)n : INT_MAX;
+    }
+
+    return 0;
+}
+
+/* bench.socket: { fastOpen, sndbuf, rcvbuf, quickack, nodelay, congestion } */
+static void extract_socket(JSContext *ctx, JSValue val, js_sockopts_t *o) {
+    JSValue v;
+
+    v = JS_GetPropertyStr(ctx, val, "fastOpen");
+    if (JS_IsBool(v)) o->fast_open = JS_ToBool(ctx, v);
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, val, "nodelay");
+    if (JS_IsBool(v)) o->nodelay = JS_ToBool(ctx, v);
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, val, "quickack");
+    if (JS_IsBool(v)) o->quickack = JS_ToBool(ctx, v);
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, val, "sndbuf");
+    o->sndbuf = extract_size(ctx, v);
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, val, "rcvbuf");
+    o->rcvbuf = extract_size(ctx, v);
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, val, "congestion");
+    if (JS_IsString(v)) {
+        const char *s = JS_ToCString(ctx, v);
+        if (s) {
+            snprintf(o->congestion, sizeof(o->congestion), "%s", s);
+            JS_FreeCString(ctx, s);
+        }
+    }
+    JS_FreeValue(ctx, v);
+}
+
+static void extract_string(JSContext *ctx, JSValue val, const char *name,
+                           char *buf, size_t size) {
+    JSValue v = JS_GetPropertyStr(ctx, val, name);
+
+    if (JS_IsString(v)) {
+        const char *s = JS_ToCString(ctx, v);
+        if (s) {
+            snprintf(buf, size, "%s", s);
+            JS_FreeCString(ctx, s);
+        }
+    }
+    JS_FreeValue(ctx, v);
+}
+
+/* bench.tls: { ktls, resume, version, ciphers, ciphersuites, alpn } */
+static int extract_tls(JSContext *ctx, JSValue val, js_tlsopts_t *o) {
+    JSValue v;
+    char version[16] = "";
+
+    v = JS_GetPropertyStr(ctx, val, "ktls");
+    if (JS_IsBool(v)) o->ktls = JS_ToBool(ctx, v);
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, val, "resume");
+    if (JS_IsBool(v)) o->resume = JS_ToBool(ctx, v);
+    JS_FreeValue(ctx, v);
+
+    extract_string(ctx, val, "version", version, sizeof(version));
+    if (strcmp(version, "1.2") == 0) o->version = TLS1_2_VERSION;
+    else if (strcmp(version, "1.3") == 0) o->version = TLS1_3_VERSION;
+    else if (version[0] != '\0') {
+        fprintf(stderr, "Error: unknown bench.tls.version '%s', "
+                        "use '1.2' or '1.3'\n", version);
+        return -1;
+    }
+
+    extract_string(ctx, val, "ciphers", o->ciphers, sizeof(o->ciphers));
+    extract_string(ctx, val, "ciphersuites", o->ciphersuites,
+                   sizeof(o->ciphersuites));
+
+    /* A list, or one protocol */
+    v = JS_GetPropertyStr(ctx, val, "alpn");
+    if (JS_IsArray(ctx, v)) {
+        JSValue len_val = JS_GetPropertyStr(ctx, v, "length");
+        int32_t n = 0;
+        size_t off = 0;
+        JS_ToInt32(ctx, &n, len_val);
+        JS_FreeValue(ctx, len_val);
+
+        for (int32_t i = 0; i < n && off < sizeof(o->alpn); i++) {
+            JSValue item = JS_GetPropertyUint32(ctx, v, (uint32_t)i);
+            const char *s = JS_ToCString(ctx, item);
+            if (s) {
+                off += (size_t)snprintf(o->alpn + off, sizeof(o->alpn) - off,
+                                        "%s%s", off ? "," : "", s);
+                JS_FreeCString(ctx, s);
+            }
+            JS_FreeValue(ctx, item);
+        }
+    }
+    JS_FreeValue(ctx, v);
+
+    if (o->alpn[0] == '\0')
+        extract_string(ctx, val, "alpn", o->alpn, sizeof(o->alpn));
+
+    return 0;
+}
+
 int js_runtime_extract_config(JSContext *ctx, JSValue bench_export,
                                js_config_t *config) {
     if (JS_IsUndefined(bench_export) || !JS_IsObject(bench_export))
@@ -47,6 +225,14 @@ int js_runtime_extract_config(JSContext *ctx, JSValue bench_export,
     }
     JS_FreeValue(ctx, v);
 
+    v = JS_GetPropertyStr(ctx, bench_export, "processes");
+    if (JS_IsNumber(v)) {
+        int32_t n;
+        JS_ToInt32(ctx, &n, v);
+        if (n > 0) config->processes = n;
+    }
+    JS_FreeValue(ctx, v);
+
     v = JS_GetPropertyStr(ctx, bench_export, "duration");
     if (JS_IsString(v)) {
         const char *s = JS_ToCString(ctx, v);
@@ -57,6 +243,171 @@ int js_runtime_extract_config(JSContext *ctx, JSValue bench_export,
     }
     JS_FreeValue(ctx, v);
 
+    v = JS_GetPropertyStr(ctx, bench_export, "warmup");
+    if (JS_IsString(v)) {
+        const char *s = JS_ToCString(ctx, v);
+        if (s) {
+            config->warmup_sec = js_parse_duration(s);
+            JS_FreeCString(ctx, s);
+        }
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, bench_export, "preconnect");
+    if (JS_IsBool(v)) {
+        config->preconnect = JS_ToBool(ctx, v);
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, bench_export, "statsVerbose");
+    if (JS_IsBool(v)) {
+        config->stats_verbose = JS_ToBool(ctx, v);
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, bench_export, "perf");
+    if (JS_IsBool(v)) {
+        config->perf = JS_ToBool(ctx, v);
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, bench_export, "keepalive");
+    if (JS_IsBool(v) && !JS_ToBool(ctx, v)) {
+        config->max_requests = 1;
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, bench_export, "maxRequests");
+    if (JS_IsNumber(v)) {
+        int32_t n;
+        JS_ToInt32(ctx, &n, v);
+        if (n > 0) config->max_requests = n;
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, bench_export, "resetOnClose");
+    if (JS_IsBool(v)) {
+        config->reset_on_close = JS_ToBool(ctx, v);
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, bench_export, "busyPoll");
+    if (JS_IsBool(v)) {
+        config->busy_poll = JS_ToBool(ctx, v);
+    } else if (JS_IsNumber(v)) {
+        int32_t n;
+        JS_ToInt32(ctx, &n, v);
+        config->busy_poll = n > 0;
+        config->busy_poll_us = n > 0 ? n : 0;
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, bench_export, "timestamps");
+    if (JS_IsString(v)) {
+        const char *s = JS_ToCString(ctx, v);
+        if (s) {
+            if (strcmp(s, "software") == 0)
+                config->timestamps = JS_TSTAMP_SOFTWARE;
+            else {
+                /* NIC stamps need SIOCSHWTSTAMP on the interface first */
+                fprintf(stderr, "Error: %s bench.timestamps '%s', "
+                                "use 'software'\n",
+                        strcmp(s, "hardware") == 0 ? "unsupported" : "unknown",
+                        s);
+                JS_FreeCString(ctx, s);
+                JS_FreeValue(ctx, v);
+                return -1;
+            }
+            JS_FreeCString(ctx, s);
+        }
+    } else if (JS_IsBool(v) && JS_ToBool(ctx, v)) {
+        config->timestamps = JS_TSTAMP_SOFTWARE;
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, bench_export, "tcpInfo");
+    if (JS_IsBool(v)) {
+        config->tcpinfo_ms = JS_ToBool(ctx, v) ? 100 : 0;
+    } else if (JS_IsString(v)) {
+        const char *s = JS_ToCString(ctx, v);
+        if (s) {
+            double sec = js_parse_duration(s);
+            config->tcpinfo_ms = sec > 0 ? (int)(sec * 1000 + 0.5) : 0;
+            if (sec > 0 && config->tcpinfo_ms == 0) config->tcpinfo_ms = 1;
+            JS_FreeCString(ctx, s);
+        }
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, bench_export, "socket");
+    if (JS_IsObject(v)) {
+        extract_socket(ctx, v, &config->sockopts);
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, bench_export, "tls");
+    if (JS_IsObject(v) && extract_tls(ctx, v, &config->tls) != 0) {
+        JS_FreeValue(ctx, v);
+        return -1;
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, bench_export, "search");
+    if (JS_IsObject(v)) {
+        config->search = extract_search(ctx, v);
+    }
+    JS_FreeValue(ctx, v);
+
+    bool policy_set = false;
+
+    v = JS_GetPropertyStr(ctx, bench_export, "addressPolicy");
+    if (JS_IsString(v)) {
+        const char *s = JS_ToCString(ctx, v);
+        if (s) {
+            policy_set = true;
+            if (strcmp(s, "roundrobin") == 0)
+                config->addr_policy = JS_ADDR_ROUNDROBIN;
+            else if (strcmp(s, "random") == 0)
+                config->addr_policy = JS_ADDR_RANDOM;
+            else if (strcmp(s, "first") == 0)
+                config->addr_policy = JS_ADDR_FIRST;
+            else {
+                fprintf(stderr, "Error: unknown bench.addressPolicy '%s', "
+                                "use 'first', 'roundrobin' or 'random'\n", s);
+                JS_FreeCString(ctx, s);
+                JS_FreeValue(ctx, v);
+                return -1;
+            }
+            JS_FreeCString(ctx, s);
+        }
+    }
+    JS_FreeValue(ctx, v);
+
+    v = JS_GetPropertyStr(ctx, bench_export, "resolve");
+    if (JS_IsArray(ctx, v)) {
+        JSValue len_val = JS_GetPropertyStr(ctx, v, "length");
+        int32_t len = 0;
+        JS_ToInt32(ctx, &len, len_val);
+        JS_FreeValue(ctx, len_val);
+
+        if (len > JS_MAX_ADDRS) len = JS_MAX_ADDRS;
+        config->resolve = calloc((size_t)(len > 0 ? len : 1), sizeof(char *));
+
+        for (int32_t i = 0; i < len && config->resolve; i++) {
+            JSValue item = JS_GetPropertyUint32(ctx, v, (uint32_t)i);
+            const char *s = JS_IsString(item) ? JS_ToCString(ctx, item) : NULL;
+            if (s) {
+                config->resolve[config->nresolve++] = strdup(s);
+                JS_FreeCString(ctx, s);
+            }
+            JS_FreeValue(ctx, item);
+        }
+
+        /* An explicit list is spread over unless told otherwise */
+        if (!policy_set) config->addr_policy = JS_ADDR_ROUNDROBIN;
+    }
+    JS_FreeValue(ctx, v);
+
     v = JS_GetPropertyStr(ctx, bench_export, "target");
     if (JS_IsString(v)) {
         const char *s = JS_ToCString(ctx, v);
@@ -82,9 +433,75 @@ int js_runtime_extract_config(JSContext *ctx, JSValue bench_export,
 
 /* ── Extract request descriptors ──────────────────────────────────────── */
 
+/* Relative paths are resolved against the script's directory */
+static void script_relative_path(js_config_t *config, const char *file,
+                                 char *path, size_t size) {
+    const char *slash = strrchr(config->script_path, '/');
+
+    if (file[0] != '/' && slash) {
+        snprintf(path, size, "%.*s/%s",
+                 (int)(slash - config->script_path), config->script_path, file);
+    } else {
+        snprintf(path, size, "%s", file);
+    }
+}
+
+/*
+ * body: { file, chunked } or { generate: '10MB', chunked }, streamed
+ * from a file descriptor instead of being built into the request.
+ */
+static int extract_body(JSContext *ctx, JSValue v_body, js_config_t *config,
+                        js_body_t *body) {
+    JSValue v_file = JS_GetPropertyStr(ctx, v_body, "file");
+    JSValue v_gen = JS_GetPropertyStr(ctx, v_body, "generate");
+    JSValue v_chunked = JS_GetPropertyStr(ctx, v_body, "chunked");
+    bool chunked = JS_ToBool(ctx, v_chunked);
+    int ret = -1;
+
+    if (JS_IsString(v_file)) {
+        const char *file = JS_ToCString(ctx, v_file);
+        char path[PATH_MAX];
+
+        script_relative_path(config, file, path, sizeof(path));
+        JS_FreeCString(ctx, file);
+
+        ret = js_body_open_file(body, path, chunked);
+        if (ret != 0)
+            fprintf(stderr, "Error: cannot open body file '%s': %s\n",
+                    path, strerror(errno));
+
+    } else if (JS_IsString(v_gen) || JS_IsNumber(v_gen)) {
+        uint64_t size = 0;
+
+        if (JS_IsNumber(v_gen)) {
+            int64_t n;
+            JS_ToInt64(ctx, &n, v_gen);
+            size = n > 0 ? (uint64_t)n : 0;
+        } else {
+            const char *s = JS_ToCString(ctx, v_gen);
+            size = js_parse_size(s);
+            if (s) JS_FreeCString(ctx, s);
+        }
+
+        ret = js_body_generate(body, size, chunked);
+        if (ret != 0)
+            fprintf(stderr, "Error: cannot generate a body of %lu bytes\n",
+                    (unsigned long)size);
+
+    } else {
+        fprintf(stderr, "Error: body object needs 'file' or 'generate'\n");
+    }
+
+    JS_FreeValue(ctx, v_file);
+    JS_FreeValue(ctx, v_gen);
+    JS_FreeValue(ctx, v_chunked);
+    return ret;
+}
+
 static int extract_single_request(JSContext *ctx, JSValue val,
                                   js_config_t *config, const char *target_override) {
     js_request_t req = {0};
+    js_body_t body = { .fd = -1 };
 
     if (JS_IsString(val)) {
         const char *s = JS_ToCString(ctx, val);
@@ -177,11 +594,21 @@ static int extract_single_request(JSContext *ctx, JSValue val,
             req.body = strdup(b);
             req.body_len = strlen(b);
             JS_FreeCString(ctx, b);
+        } else if (JS_IsObject(v_body) &&
+                   extract_body(ctx, v_body, config, &body) != 0)
+        {
+            JS_FreeValue(ctx, v_url);
+            JS_FreeValue(ctx, v_method);
+            JS_FreeValue(ctx, v_body);
+            JS_FreeValue(ctx, v_headers);
+            js_request_free(&req);
+            return -1;
         }
 
+        char hdr_buf[4096] = "";
+        int off = 0;
+
         if (JS_IsObject(v_headers)) {
-            char hdr_buf[4096] = "";
-            int off = 0;
             JSPropertyEnum *tab;
             uint32_t len;
             if (JS_GetOwnPropertyNames(ctx, &tab, &len, v_headers,
@@ -202,9 +629,15 @@ static int extract_single_request(JSContext *ctx, JSValue val,
                 }
                 js_free(ctx, tab);
             }
-            if (off > 0) req.headers = strdup(hdr_buf);
         }
 
+        /* The request head announces a streamed body itself */
+        if (body.fd >= 0)
+            off += js_body_header(&body, hdr_buf + off,
+                                  sizeof(hdr_buf) - (size_t)off);
+
+        if (off > 0) req.headers = strdup(hdr_buf);
+
         JS_FreeValue(ctx, v_url);
         JS_FreeValue(ctx, v_method);
         JS_FreeValue(ctx, v_body);
@@ -218,19 +651,48 @@ static int extract_single_request(JSContext *ctx, JSValue val,
     js_buf_t *tmp = realloc(config->requests,
                             sizeof(js_buf_t) * (size_t)(config->request_count + 1));
     if (!tmp) {
+        js_body_close(&body);
         js_request_free(&req);
         return -1;
     }
     config->requests = tmp;
 
+    js_template_t *ttmp = realloc(config->templates,
+                            sizeof(js_template_t) * (size_t)(config->request_count + 1));
+    if (!ttmp) {
+        js_body_close(&body);
+        js_request_free(&req);
+        return -1;
+    }
+    config->templates = ttmp;
+
+    js_body_t *btmp = realloc(config->bodies,
+                            sizeof(js_body_t) * (size_t)(config->request_count + 1));
+    if (!btmp) {
+        js_body_close(&body);
+        js_request_free(&req);
+        return -1;
+    }
+    config->bodies = btmp;
+
     js_buf_t *buf = &config->requests[config->request_count];
     memset(buf, 0, sizeof(*buf));
 
     if (js_request_serialize(&req, config->host, buf) != 0) {
+        js_body_close(&body);
+        js_request_free(&req);
+        return -1;
+    }
+
+    /* Precompile ${...} variables so workers can fill them in natively */
+    if (js_template_compile(&config->templates[config->request_count], buf) != 0) {
+        js_buf_free(buf);
+        js_body_close(&body);
         js_request_free(&req);
         return -1;
     }
 
+    config->bodies[config->request_count] = body;
     config->request_count++;
 
     if (config->request_count == 1) {
@@ -242,13 +704,135 @@ static int extract_single_request(JSContext *ctx, JSValue val,
     return 0;
 }
 
+/* { file, format, url }: requests are read from a memory-mapped file */
+static int extract_request_file(JSContext *ctx, JSValue val, JSValue v_file,
+                                js_config_t *config) {
+    JSValue v_format = JS_GetPropertyStr(ctx, val, "format");
+    JSValue v_url = JS_GetPropertyStr(ctx, val, "url");
+    const char *file = JS_ToCString(ctx, v_file);
+    const char *format = JS_IsString(v_format) ? JS_ToCString(ctx, v_format) : NULL;
+    const char *url = JS_IsString(v_url) ? JS_ToCString(ctx, v_url) : NULL;
+    const char *base = config->target ? config->target : url;
+    int ret = -1;
+
+    if (!file) goto done;
+
+    if (!base) {
+        fprintf(stderr, "Error: a request file needs 'url' or bench 'target'\n");
+        goto done;
+    }
+
+    if (js_parse_url(base, &config->url) != 0) {
+        fprintf(stderr, "Error: invalid URL '%s'\n", base);
+        goto done;
+    }
+    config->use_tls = config->url.is_tls;
+
+    char path[PATH_MAX];
+    script_relative_path(config, file, path, sizeof(path));
+
+    config->reqfile = js_reqfile_open(path, format);
+    if (!config->reqfile) {
+        fprintf(stderr, "Error: cannot load request file '%s': %s\n",
+                path, strerror(errno));
+        goto done;
+    }
+
+    js_reqfile_set_host(config->reqfile, &config->url, config->host);
+    ret = 0;
+
+done:
+    if (file) JS_FreeCString(ctx, file);
+    if (format) JS_FreeCString(ctx, format);
+    if (url) JS_FreeCString(ctx, url);
+    JS_FreeValue(ctx, v_format);
+    JS_FreeValue(ctx, v_url);
+    return ret;
+}
+
+/* { replay, format, url, speedup }: replay an access log or HAR file */
+static int extract_replay(JSContext *ctx, JSValue val, JSValue v_replay,
+                          js_config_t *config) {
+    JSValue v_format = JS_GetPropertyStr(ctx, val, "format");
+    JSValue v_url = JS_GetPropertyStr(ctx, val, "url");
+    JSValue v_speedup = JS_GetPropertyStr(ctx, val, "speedup");
+    const char *file = JS_ToCString(ctx, v_replay);
+    const char *format = JS_IsString(v_format) ? JS_ToCString(ctx, v_format) : NULL;
+    const char *url = JS_IsString(v_url) ? JS_ToCString(ctx, v_url) : NULL;
+    const char *base = config->target ? config->target : url;
+    double speedup = 1.0;
+    int ret = -1;
+
+    if (JS_IsNumber(v_speedup)) JS_ToFloat64(ctx, &speedup, v_speedup);
+
+    if (!file) goto done;
+
+    if (!base) {
+        fprintf(stderr, "Error: replay needs 'url' or bench 'target'\n");
+        goto done;
+    }
+
+    if (js_parse_url(base, &config->url) != 0) {
+        fprintf(stderr, "Error: invalid URL '%s'\n", base);
+        goto done;
+    }
+    config->use_tls = config->url.is_tls;
+
+    char path[PATH_MAX];
+    script_relative_path(config, file, path, sizeof(path));
+
+    config->replay = js_replay_load(ctx, path, format, &config->url,
+                                    config->host, speedup);
+    if (!config->replay) {
+        fprintf(stderr, "Error: cannot load replay file '%s': %s\n",
+                path, strerror(errno));
+        goto done;
+    }
+
+    if (config->replay->skipped > 0)
+        fprintf(stderr, "Warning: skipped %d unparsable replay entries\n",
+                config->replay->skipped);
+    ret = 0;
+
+done:
+    if (file) JS_FreeCString(ctx, file);
+    if (format) JS_FreeCString(ctx, format);
+    if (url) JS_FreeCString(ctx, url);
+    JS_FreeValue(ctx, v_format);
+    JS_FreeValue(ctx, v_url);
+    JS_FreeValue(ctx, v_speedup);
+    return ret;
+}
+
 int js_runtime_extract_requests(JSContext *ctx, JSValue default_export,
                                  js_config_t *config) {
     config->requests = NULL;
+    config->templates = NULL;
+    config->bodies = NULL;
     config->request_count = 0;
+    config->reqfile = NULL;
+    config->replay = NULL;
 
     const char *target = config->target;
 
+    if (JS_IsObject(default_export) && !JS_IsArray(ctx, default_export)) {
+        JSValue v_file = JS_GetPropertyStr(ctx, default_export, "file");
+        if (JS_IsString(v_file)) {
+            int ret = extract_request_file(ctx, default_export, v_file, config);
+            JS_FreeValue(ctx, v_file);
+            return ret;
+        }
+        JS_FreeValue(ctx, v_file);
+
+        JSValue v_replay = JS_GetPropertyStr(ctx, default_export, "replay");
+        if (JS_IsString(v_replay)) {
+            int ret = extract_replay(ctx, default_export, v_replay, config);
+            JS_FreeValue(ctx, v_replay);
+            return ret;
+        }
+        JS_FreeValue(ctx, v_replay);
+    }
+
     if (JS_IsString(default_export) || JS_IsObject(default_export)) {
         if (JS_IsArray(ctx, default_export)) {
             /* Array of requests */
@@ -273,17 +857,645 @@ int js_runtime_extract_requests(JSContext *ctx, JSValue default_export,
     return 0;
 }
 
-/* ── Benchmark mode ──────────────────────────────────────────────────── */
+/* ── Target addresses ─────────────────────────────────────────────────── */
 
-int js_bench_run(js_config_t *config) {
-    int nthreads = config->threads;
-    int nconns = config->connections;
+static void bench_addr_name(js_addr_t *a) {
+    char ip[INET6_ADDRSTRLEN];
 
-    if (nthreads <= 0) nthreads = 1;
-    if (nconns <= 0) nconns = 1;
-    if (nthreads > nconns) nthreads = nconns;
+    if (a->sa.ss_family == AF_INET6) {
+        struct sockaddr_in6 *sin6 = (struct sockaddr_in6 *)&a->sa;
+        inet_ntop(AF_INET6, &sin6->sin6_addr, ip, sizeof(ip));
+        snprintf(a->name, sizeof(a->name), "[%s]:%d", ip, ntohs(sin6->sin6_port));
+    } else {
+        struct sockaddr_in *sin = (struct sockaddr_in *)&a->sa;
+        inet_ntop(AF_INET, &sin->sin_addr, ip, sizeof(ip));
+        snprintf(a->name, sizeof(a->name), "%s:%d", ip, ntohs(sin->sin_port));
+    }
+}
 
-    /* Resolve DNS once */
+/* Append every result not seen yet; returns the new count */
+static int bench_addr_add(js_addr_t *addrs, int n, const struct addrinfo *res) {
+    for (; res && n < JS_MAX_ADDRS; res = res->ai_next) {
+        bool dup = false;
+
+        for (int i = 0; i < n && !dup; i++) {
+            dup = addrs[i].len == res->ai_addrlen &&
+                  memcmp(&addrs[i].sa, res->ai_addr, res->ai_addrlen) == 0;
+        }
+        if (dup) continue;
+
+        memcpy(&addrs[n].sa, res->ai_addr, res->ai_addrlen);
+        addrs[n].len = res->ai_addrlen;
+        bench_addr_name(&addrs[n]);
+        n++;
+    }
+
+    return n;
+}
+
+/*
+ * Resolve the addresses to connect to: all DNS results for the target,
+ * or the bench.resolve list ("ip" or "ip:port") when one is given.
+ */
+static int bench_resolve(js_config_t *config, const js_url_t *url) {
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM };
+    struct addrinfo *res = NULL;
+
+    config->addrs = calloc(JS_MAX_ADDRS, sizeof(js_addr_t));
+    if (!config->addrs) return -1;
+    config->naddrs = 0;
+
+    if (config->nresolve == 0) {
+        int gai_err = getaddrinfo(url->host, url->port_str, &hints, &res);
+        if (gai_err != 0 || !res) {
+            fprintf(stderr, "DNS resolution failed for %s: %s\n",
+                    url->host, gai_strerror(gai_err));
+            return -1;
+        }
+
+        config->naddrs = bench_addr_add(config->addrs, 0, res);
+        freeaddrinfo(res);
+
+    } else {
+        hints.ai_flags = AI_NUMERICHOST;
+
+        for (int i = 0; i < config->nresolve; i++) {
+            char host[256];
+            const char *port = url->port_str;
+            const char *entry = config->resolve[i];
+            const char *colon = strrchr(entry, ':');
+
+            /* "ip:port" or "[ipv6]:port"; a bare IPv6 address has no port */
+            if (entry[0] == '[') {
+                const char *rb = strchr(entry, ']');
+                if (!rb) goto invalid;
+                snprintf(host, sizeof(host), "%.*s", (int)(rb - entry - 1), entry + 1);
+                if (rb[1] == ':') port = rb + 2;
+            } else if (colon && strchr(entry, ':') == colon) {
+                snprintf(host, sizeof(host), "%.*s", (int)(colon - entry), entry);
+                port = colon + 1;
+            } else {
+                snprintf(host, sizeof(host), "%s", entry);
+            }
+
+            if (getaddrinfo(host, port, &hints, &res) != 0 || !res) goto invalid;
+
+            config->naddrs = bench_addr_add(config->addrs, config->naddrs, res);
+            freeaddrinfo(res);
+            continue;
+
+        invalid:
+            fprintf(stderr, "Error: invalid bench.resolve address '%s'\n",
+                    entry);
+            return -1;
+        }
+    }
+
+    if (config->naddrs == 0) return -1;
+    if (config->addr_policy == JS_ADDR_FIRST) config->naddrs = 1;
+
+    return 0;
+}
+
+/*
+ * bench.timestamps: time to first byte by the kernel's clock, from the
+ * request's last byte leaving the stack to the response arriving.  Kept
+ * apart from the latency above, which is timed as usual.
+ */
+static void bench_print_timestamps(js_worker_t *workers, int nworkers,
+                                   uint64_t requests) {
+    js_hist_t *h = malloc(sizeof(js_hist_t));
+    if (!h) return;
+
+    js_hist_init(h);
+    for (int i = 0; i < nworkers; i++) {
+        if (workers[i].kernel_latency)
+            js_hist_merge(h, workers[i].kernel_latency);
+    }
+
+    char buf[4][32];
+    js_format_duration(js_hist_percentile(h, 50), buf[0], sizeof(buf[0]));
+    js_format_duration(js_hist_percentile(h, 90), buf[1], sizeof(buf[1]));
+    js_format_duration(js_hist_percentile(h, 99), buf[2], sizeof(buf[2]));
+    js_format_duration(js_hist_percentile(h, 99.9), buf[3], sizeof(buf[3]));
+
+    printf("  timestamps p50       p90       p99       p999      "
+           "(%lu of %lu response(s))\n",
+           (unsigned long)h->count, (unsigned long)requests);
+    printf("             %-10s%-10s%-10s%-10s\n\n",
+           buf[0], buf[1], buf[2], buf[3]);
+
+    free(h);
+}
+
+static void bench_print_tcpinfo(js_config_t *config, js_worker_t *workers,
+                                int nworkers) {
+    js_tcpinfo_t *t = malloc(sizeof(js_tcpinfo_t));
+    if (!t) return;
+
+    js_tcpinfo_init(t);
+    for (int i = 0; i < nworkers; i++) {
+        if (workers[i].tcpinfo) js_tcpinfo_merge(t, workers[i].tcpinfo);
+    }
+
+    if (t->samples == 0) {
+        free(t);
+        return;
+    }
+
+    const struct { const char *name; js_hist_t *h; bool us; } rows[] = {
+        { "rtt",     &t->rtt,     true  },
+        { "rttvar",  &t->rttvar,  true  },
+        { "cwnd",    &t->cwnd,    false },
+        { "unacked", &t->unacked, false },
+    };
+
+    printf("  tcp_info   p50       p99       max       (%lu samples, "
+           "%lu retransmits)\n",
+           (unsigned long)t->samples, (unsigned long)t->retrans);
+
+    for (size_t i = 0; i < sizeof(rows) / sizeof(rows[0]); i++) {
+        double v[3] = {
+            js_hist_percentile(rows[i].h, 50),
+            js_hist_percentile(rows[i].h, 99),
+            rows[i].h->max_val,
+        };
+        char buf[3][32];
+
+        for (int k = 0; k < 3; k++) {
+            if (rows[i].us)
+                js_format_duration(v[k], buf[k], sizeof(buf[k]));
+            else
+                snprintf(buf[k], sizeof(buf[k]), "%.0f", v[k]);
+        }
+
+        printf("  %-11s%-10s%-10s%-10s\n", rows[i].name, buf[0], buf[1], buf[2]);
+    }
+    printf("\n");
+
+    printf("  slowest    conn      rtt       rttvar    rto       retrans   cwnd      unacked%s\n",
+           config->naddrs > 1 ? "   address" : "");
+
+    for (int i = 0; i < t->nslowest; i++) {
+        js_tcpinfo_slow_t *s = &t->slowest[i];
+        char lat_buf[32], rtt_buf[32], var_buf[32], rto_buf[32];
+
+        js_format_duration(s->latency_us, lat_buf, sizeof(lat_buf));
+        js_format_duration(s->rtt_us, rtt_buf, sizeof(rtt_buf));
+        js_format_duration(s->rttvar_us, var_buf, sizeof(var_buf));
+        js_format_duration(s->rto_us, rto_buf, sizeof(rto_buf));
+
+        printf("  %-11s%-10d%-10s%-10s%-10s%-10u%-10u%-10u",
+               lat_buf, s->conn, rtt_buf, var_buf, rto_buf,
+               s->retrans, s->cwnd, s->unacked);
+        if (config->naddrs > 1) printf("%s", config->addrs[s->addr].name);
+        printf("\n");
+    }
+    printf("\n");
+
+    free(t);
+}
+
+/* CPU time used by this process and the worker processes it reaped */
+static void bench_cpu_time(double *user, double *sys) {
+    struct rusage self, children;
+
+    getrusage(RUSAGE_SELF, &self);
+    getrusage(RUSAGE_CHILDREN, &children);
+
+    *user = (double)(self.ru_utime.tv_sec + children.ru_utime.tv_sec) +
+            (double)(self.ru_utime.tv_usec + children.ru_utime.tv_usec) / 1e6;
+    *sys = (double)(self.ru_stime.tv_sec + children.ru_stime.tv_sec) +
+           (double)(self.ru_stime.tv_usec + children.ru_stime.tv_usec) / 1e6;
+}
+
+/*
+ * What the client itself cost: CPU per worker thread, how long a turn of
+ * the event loop took, memory, and the epoll syscalls made per request.
+ * A worker close to a full core is the likely bottleneck, not the server,
+ * unless it spins in a busy-polling loop and is always at one.
+ */
+static void bench_print_self(js_worker_t *workers, int nworkers,
+                             uint64_t requests, bool busy_poll) {
+    js_hist_t *lag = malloc(sizeof(js_hist_t));
+    if (!lag) return;
+
+    double cores = 0, busiest = 0;
+    uint64_t wakeups = 0, events = 0, waits = 0, ctls = 0;
+    int saturated = 0;
+
+    js_hist_init(lag);
+
+    for (int i = 0; i < nworkers; i++) {
+        js_worker_t *w = &workers[i];
+        double wall = (double)w->cpu_ns / 1e9;
+        double busy = wall > 0 ? (w->cpu_user + w->cpu_sys) / wall : 0;
+
+        cores += busy;
+        if (busy > busiest) busiest = busy;
+        if (busy >= JS_SATURATED) saturated++;
+
+        wakeups += w->wakeups;
+        events += w->events;
+        waits += w->counters.epoll_waits;
+        ctls += w->counters.epoll_ctls;
+        if (w->loop_lag) js_hist_merge(lag, w->loop_lag);
+    }
+
+    struct rusage self, children;
+    getrusage(RUSAGE_SELF, &self);
+    getrusage(RUSAGE_CHILDREN, &children);
+
+    /* Peak of this process, or of the largest worker process */
+    long rss_kb = self.ru_maxrss > children.ru_maxrss ? self.ru_maxrss
+                                                      : children.ru_maxrss;
+
+    char p50_buf[32], p99_buf[32], ev_buf[16], rss_buf[32], busy_buf[16];
+    js_format_bytes((uint64_t)rss_kb * 1024, rss_buf, sizeof(rss_buf));
+    snprintf(busy_buf, sizeof(busy_buf), "%.0f%%", busiest * 100);
+
+    /* fetch() drives its own loop, which is not timed turn by turn */
+    if (wakeups > 0) {
+        js_format_duration(js_hist_percentile(lag, 50), p50_buf,
+                           sizeof(p50_buf));
+        js_format_duration(js_hist_percentile(lag, 99), p99_buf,
+                           sizeof(p99_buf));
+        snprintf(ev_buf, sizeof(ev_buf), "%.1f",
+                 (double)events / (double)wakeups);
+    } else {
+        strcpy(p50_buf, "n/a");
+        strcpy(p99_buf, "n/a");
+        strcpy(ev_buf, "n/a");
+    }
+
+    printf("  client     cores     busiest   lag p50   lag p99   "
+           "ev/wakeup max rss\n");
+    printf("             %-10.2f%-10s%-10s%-10s%-10s%s\n",
+           cores, busy_buf, p50_buf, p99_buf, ev_buf, rss_buf);
+
+    double per = requests ? 1.0 / (double)requests : 0;
+
+    printf("  syscalls   epoll_wait epoll_ctl  wait/req  ctl/req\n");
+    printf("             %-11lu%-11lu%-10.2f%.2f\n\n",
+           (unsigned long)waits, (unsigned long)ctls,
+           (double)waits * per, (double)ctls * per);
+
+    if (saturated > 0 && !busy_poll) {
+        printf("Warning: %d of %d worker thread(s) used over %.0f%% of a core. "
+               "The client may be\n"
+               "the bottleneck, not the server; add threads or processes.\n\n",
+               saturated, nworkers, JS_SATURATED * 100);
+    }
+
+    free(lag);
+}
+
+static double bench_ratio(uint64_t a, uint64_t b) {
+    return b ? (double)a / (double)b : 0;
+}
+
+/*
+ * bench.statsVerbose: per worker, what its syscalls moved and how much
+ * work each response took, then the errors by the step that failed.
+ */
+static void bench_print_verbose(js_worker_t *workers, int nworkers,
+                                const js_stats_t *total) {
+    printf("  io         reads     B/read    writes    B/write   "
+           "wire in   wire out\n");
+
+    for (int i = 0; i < nworkers; i++) {
+        js_counters_t *k = &workers[i].counters;
+        char in_buf[32], out_buf[32], label[24];
+
+        js_format_bytes(k->read_bytes, in_buf, sizeof(in_buf));
+        js_format_bytes(k->write_bytes, out_buf, sizeof(out_buf));
+        snprintf(label, sizeof(label), "worker %d", i);
+
+        printf("  %-11s%-10lu%-10.0f%-10lu%-10.0f%-10s%s\n", label,
+               (unsigned long)k->reads, bench_ratio(k->read_bytes, k->reads),
+               (unsigned long)k->writes,
+               bench_ratio(k->write_bytes, k->writes), in_buf, out_buf);
+    }
+
+    printf("\n  loop       epoll_wait ev/wait   epoll_ctl parse/rsp "
+           "buf grows\n");
+
+    for (int i = 0; i < nworkers; i++) {
+        js_counters_t *k = &workers[i].counters;
+        char label[24];
+
+        snprintf(label, sizeof(label), "worker %d", i);
+
+        printf("  %-11s%-11lu%-10.1f%-10lu%-10.2f%lu\n", label,
+               (unsigned long)k->epoll_waits,
+               bench_ratio(k->epoll_events, k->epoll_waits),
+               (unsigned long)k->epoll_ctls,
+               bench_ratio(k->parses, k->responses),
+               (unsigned long)k->buf_grows);
+    }
+
+    printf("\n  errors     connect   read      write\n");
+    printf("             %-10lu%-10lu%lu\n\n",
+           (unsigned long)total->connect_errors,
+           (unsigned long)total->read_errors,
+           (unsigned long)total->write_errors);
+}
+
+static const char *bench_perf_error(int error) {
+    switch (error) {
+        case EACCES:
+        case EPERM:
+            return "not permitted, see kernel.perf_event_paranoid";
+        case ENOENT:
+        case ENODEV:
+        case EOPNOTSUPP:
+            return "no such counter on this CPU (or VM)";
+        case ENOSYS:
+            return "no perf_event_open() in this kernel";
+        default:
+            return strerror(error);
+    }
+}
+
+/*
+ * bench.perf: the client's hardware counters per request.  Events a
+ * worker could not count are left out of the sums; if none could, say
+ * why.
+ */
+static void bench_print_perf(js_worker_t *workers, int nworkers,
+                             uint64_t requests) {
+    uint64_t sum[JS_PERF_NEVENTS] = {0};
+    uint32_t opened = 0;
+    bool user_only = false;
+    int error = 0;
+
+    for (int i = 0; i < nworkers; i++) {
+        js_perf_t *p = &workers[i].perf;
+
+        for (int e = 0; e < JS_PERF_NEVENTS; e++) {
+            if (p->opened & (1u << e)) sum[e] += p->value[e];
+        }
+        opened |= p->opened;
+        user_only |= p->user_only;
+        if (error == 0) error = p->error;
+    }
+
+    if (opened == 0) {
+        printf("  perf       unavailable: %s\n\n", bench_perf_error(error));
+        return;
+    }
+
+    double per[JS_PERF_NEVENTS];
+    char cols[JS_PERF_NEVENTS + 1][16];
+
+    for (int e = 0; e < JS_PERF_NEVENTS; e++) {
+        per[e] = bench_ratio(sum[e], requests);
+        if (opened & (1u << e))
+            snprintf(cols[e], sizeof(cols[e]), "%.1f", per[e]);
+        else
+            snprintf(cols[e], sizeof(cols[e]), "-");
+    }
+
+    /* Instructions per cycle, in place of a per-request count */
+    uint32_t ipc = (1u << JS_PERF_CYCLES) | (1u << JS_PERF_INSTRUCTIONS);
+    if ((opened & ipc) == ipc)
+        snprintf(cols[JS_PERF_NEVENTS], sizeof(cols[0]), "%.2f",
+                 bench_ratio(sum[JS_PERF_INSTRUCTIONS], sum[JS_PERF_CYCLES]));
+    else
+        snprintf(cols[JS_PERF_NEVENTS], sizeof(cols[0]), "-");
+
+    printf("  perf       cycles/req insns/req  IPC        cache/req  "
+           "branch/req cswitch/req\n");
+    printf("             %-11s%-11s%-11s%-11s%-11s%s\n",
+           cols[JS_PERF_CYCLES], cols[JS_PERF_INSTRUCTIONS],
+           cols[JS_PERF_NEVENTS], cols[JS_PERF_CACHE_MISSES],
+           cols[JS_PERF_BRANCH_MISSES], cols[JS_PERF_CONTEXT_SWITCHES]);
+
+    if (opened != (1u << JS_PERF_NEVENTS) - 1)
+        printf("             -: not counted, %s\n", bench_perf_error(error));
+    if (user_only)
+        printf("             user space only (kernel.perf_event_paranoid)\n");
+    printf("\n");
+}
+
+static void bench_print_addrs(js_config_t *config, js_worker_t *workers,
+                              int nworkers) {
+    js_addr_stats_t *s = malloc(sizeof(js_addr_stats_t));
+    if (!s) return;
+
+    printf("  address                  requests  errors    p50       p99\n");
+
+    for (int a = 0; a < config->naddrs; a++) {
+        char p50_buf[32], p99_buf[32];
+
+        js_addr_stats_init(s);
+        for (int i = 0; i < nworkers; i++) {
+            if (workers[i].addr_stats)
+                js_addr_stats_merge(s, &workers[i].addr_stats[a]);
+        }
+
+        js_format_duration(js_hist_percentile(&s->latency, 50),
+                           p50_buf, sizeof(p50_buf));
+        js_format_duration(js_hist_percentile(&s->latency, 99),
+                           p99_buf, sizeof(p99_buf));
+
+        printf("  %-25s%-10lu%-10lu%-10s%-10s\n",
+               config->addrs[a].name, (unsigned long)s->requests,
+               (unsigned long)s->errors, p50_buf, p99_buf);
+    }
+
+    printf("\n");
+    free(s);
+}
+
+/* ── Worker processes ─────────────────────────────────────────────────── */
+
+/*
+ * With bench.processes the worker threads are split over forked
+ * processes, which share no malloc arenas and no OpenSSL state.  The
+ * worker array and what hangs off it (per-address stats, tcpInfo samples,
+ * loop lag) live in shared mappings, so the parent reads every worker's
+ * results once the processes exit.
+ */
+
+static void *bench_shared_alloc(size_t size) {
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? NULL : p;
+}
+
+static void bench_workers_free(js_config_t *config, js_worker_t *workers,
+                               int n, bool shared) {
+    if (!shared) {
+        for (int i = 0; i < n; i++) {
+            free(workers[i].addr_stats);
+            free(workers[i].tcpinfo);
+            free(workers[i].loop_lag);
+            free(workers[i].kernel_latency);
+        }
+        free(workers);
+        return;
+    }
+
+    if (workers[0].addr_stats) {
+        munmap(workers[0].addr_stats,
+               sizeof(js_addr_stats_t) * (size_t)config->naddrs * (size_t)n);
+    }
+    if (workers[0].tcpinfo)
+        munmap(workers[0].tcpinfo, sizeof(js_tcpinfo_t) * (size_t)n);
+    if (workers[0].loop_lag)
+        munmap(workers[0].loop_lag, sizeof(js_hist_t) * (size_t)n);
+    if (workers[0].kernel_latency)
+        munmap(workers[0].kernel_latency, sizeof(js_hist_t) * (size_t)n);
+    munmap(workers, sizeof(js_worker_t) * (size_t)n);
+}
+
+static js_worker_t *bench_workers_alloc(js_config_t *config, int n,
+                                        bool shared) {
+    if (!shared) return calloc((size_t)n, sizeof(js_worker_t));
+
+    js_worker_t *workers = bench_shared_alloc(sizeof(js_worker_t) * (size_t)n);
+    if (!workers) return NULL;
+
+    size_t naddrs = config->naddrs > 1 ? (size_t)config->naddrs : 0;
+    js_addr_stats_t *addr_stats = NULL;
+    js_tcpinfo_t *tcpinfo = NULL;
+    js_hist_t *loop_lag, *kernel_latency = NULL;
+
+    if (naddrs) {
+        addr_stats = bench_shared_alloc(sizeof(js_addr_stats_t) * naddrs *
+                                        (size_t)n);
+    }
+    if (config->tcpinfo_ms > 0)
+        tcpinfo = bench_shared_alloc(sizeof(js_tcpinfo_t) * (size_t)n);
+    loop_lag = bench_shared_alloc(sizeof(js_hist_t) * (size_t)n);
+
+    for (int i = 0; i < n; i++) {
+        if (addr_stats) workers[i].addr_stats = addr_stats + naddrs * (size_t)i;
+        if (tcpinfo) workers[i].tcpinfo = tcpinfo + i;
+        if (loop_lag) workers[i].loop_lag = loop_lag + i;
+    }
+
+    if (config->timestamps != JS_TSTAMP_NONE) {
+        kernel_latency = bench_shared_alloc(sizeof(js_hist_t) * (size_t)n);
+        for (int i = 0; i < n && kernel_latency; i++)
+            workers[i].kernel_latency = kernel_latency + i;
+    }
+
+    if ((naddrs && !addr_stats) || (config->tcpinfo_ms > 0 && !tcpinfo) ||
+        !loop_lag || (config->timestamps != JS_TSTAMP_NONE && !kernel_latency))
+    {
+        bench_workers_free(config, workers, n, true);
+        return NULL;
+    }
+
+    return workers;
+}
+
+static void bench_process_run(js_worker_t *workers, int from, int to) {
+    for (int i = from; i < to; i++)
+        pthread_create(&workers[i].thread, NULL, js_worker_run, &workers[i]);
+
+    for (int i = from; i < to; i++)
+        pthread_join(workers[i].thread, NULL);
+
+    fflush(stdout);
+    _exit(0);
+}
+
+/* Fork nprocs processes, each running its share of the workers */
+static int bench_fork(js_worker_t *workers, int nworkers, pid_t *pids,
+                      int nprocs) {
+    int per_proc = nworkers / nprocs;
+    int extra = nworkers % nprocs;
+    int from = 0;
+
+    fflush(stdout);
+    fflush(stderr);
+
+    for (int p = 0; p < nprocs; p++) {
+        int to = from + per_proc + (p < extra ? 1 : 0);
+
+        pids[p] = fork();
+
+        if (pids[p] == 0) {
+            bench_process_run(workers, from, to);
+        }
+
+        if (pids[p] < 0) {
+            fprintf(stderr, "Error: fork: %s\n", strerror(errno));
+            for (int k = 0; k < p; k++) {
+                kill(pids[k], SIGKILL);
+                waitpid(pids[k], NULL, 0);
+            }
+            return -1;
+        }
+
+        from = to;
+    }
+
+    return 0;
+}
+
+static int bench_wait(pid_t *pids, int nprocs) {
+    int ret = 0;
+
+    for (int p = 0; p < nprocs; p++) {
+        int status;
+
+        while (waitpid(pids[p], &status, 0) < 0 && errno == EINTR) { }
+
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "Error: worker process %d failed\n", (int)pids[p]);
+            ret = -1;
+        }
+    }
+
+    return ret;
+}
+
+/* ── Benchmark mode ──────────────────────────────────────────────────── */
+
+int js_bench_run(js_config_t *config) {
+    int nthreads = config->threads;
+    int nconns = config->connections;
+    int nprocs = config->processes;
+
+    if (nthreads <= 0) nthreads = 1;
+    if (nconns <= 0) nconns = 1;
+    if (nprocs <= 0) nprocs = 1;
+    if (nthreads < nprocs) nthreads = nprocs;
+    if (nthreads > nconns) nthreads = nconns;
+    if (nprocs > nthreads) nprocs = nthreads;
+
+    if (config->search &&
+        (config->mode == MODE_BENCH_ASYNC || config->replay || config->remote))
+    {
+        fprintf(stderr, "Error: bench.search needs a URL, request or "
+                        "request file export, run locally\n");
+        return 1;
+    }
+
+    if (config->search && nprocs > 1) {
+        fprintf(stderr, "Error: bench.search runs in a single process\n");
+        return 1;
+    }
+
+    /* Each step already drops whatever the rate switch recorded */
+    if (config->search && (config->preconnect || config->warmup_sec > 0)) {
+        fprintf(stderr, "Error: bench.search cannot be used with "
+                        "preconnect or warmup\n");
+        return 1;
+    }
+
+    /* A fast open connection sends no SYN until it has a request to send */
+    if (config->preconnect && config->sockopts.fast_open) {
+        fprintf(stderr, "Error: bench.preconnect cannot be used with "
+                        "socket.fastOpen\n");
+        return 1;
+    }
+
+    /* Resolve DNS once */
     js_url_t *first_url = &config->url;
 
     /* If target override, use that for DNS */
@@ -294,94 +1506,458 @@ int js_bench_run(js_config_t *config) {
         }
     }
 
-    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM };
-    struct addrinfo *res = NULL;
-    int gai_err = getaddrinfo(first_url->host, first_url->port_str, &hints, &res);
-    if (gai_err != 0 || !res) {
-        fprintf(stderr, "DNS resolution failed for %s: %s\n",
-                first_url->host, gai_strerror(gai_err));
-        return 1;
-    }
-
-    memcpy(&config->addr, res->ai_addr, res->ai_addrlen);
-    config->addr_len = res->ai_addrlen;
-    freeaddrinfo(res);
+    if (bench_resolve(config, first_url) != 0) return 1;
 
-    /* Create TLS context if needed */
+    /* Check the TLS options once; every worker makes its own context */
     if (config->use_tls) {
-        config->ssl_ctx = js_tls_ctx_create();
-        if (!config->ssl_ctx) {
-            fprintf(stderr, "Failed to create TLS context\n");
+        SSL_CTX *ctx = js_tls_ctx_create(&config->tls);
+        if (!ctx) {
+            fprintf(stderr, "Error: cannot create a TLS context with these "
+                            "ciphers, version or alpn\n");
             return 1;
         }
+        SSL_CTX_free(ctx);
     }
 
     /* Print benchmark info */
     printf("Running benchmark: %d connection(s), %d thread(s)",
            nconns, nthreads);
+    if (nprocs > 1)
+        printf(" in %d processes", nprocs);
     if (config->duration_sec > 0)
         printf(", %.0fs duration", config->duration_sec);
+    if (config->warmup_sec > 0)
+        printf(", %.0fs warmup", config->warmup_sec);
     printf("\n");
     printf("Target: %s://%s:%d%s\n",
            config->url.scheme,
            config->url.host,
            config->url.port,
            config->url.path);
+    if (config->max_requests > 0 && config->mode != MODE_BENCH_ASYNC) {
+        printf("Connections: reopened every %d request(s)%s\n",
+               config->max_requests,
+               config->reset_on_close ? ", closed with RST" : "");
+    }
+    if (config->busy_poll && config->mode != MODE_BENCH_ASYNC) {
+        if (config->busy_poll_us > 0)
+            printf("Polling: busy, SO_BUSY_POLL %dus\n", config->busy_poll_us);
+        else
+            printf("Polling: busy\n");
+    }
+    if (config->naddrs > 1) {
+        printf("Addresses: %d (%s)\n", config->naddrs,
+               config->addr_policy == JS_ADDR_RANDOM ? "random" : "round-robin");
+    }
     if (config->mode == MODE_BENCH_ASYNC)
         printf("Mode: async function (JS path)\n");
+    else if (config->replay)
+        printf("Mode: replay (%d requests, C path)\n", config->replay->count);
+    else if (config->reqfile)
+        printf("Mode: request file (%d requests, C path)\n",
+               config->reqfile->count);
     else if (config->mode == MODE_BENCH_ARRAY)
         printf("Mode: array round-robin (%d endpoints)\n", config->request_count);
     else
         printf("Mode: %s (C path)\n",
                config->mode == MODE_BENCH_STRING ? "string" : "object");
+    if (config->search) {
+        char slo_buf[32];
+        js_format_duration(config->search->p99_us, slo_buf, sizeof(slo_buf));
+        printf("Search: p99 <= %s, errors <= %.2f%%, %gs steps\n",
+               slo_buf, config->search->error_rate * 100,
+               config->search->step_sec);
+    }
     printf("\n");
 
+    /* Distributed run: tell the coordinator, and wait for the start time */
+    if (config->remote && config->remote->ready) {
+        double run_sec = config->duration_sec > 0 && !config->search
+                       ? config->warmup_sec + config->duration_sec : 0;
+
+        if (config->remote->ready(config->remote, run_sec) != 0) return 1;
+    }
+
     /* Allocate workers */
-    js_worker_t *workers = calloc((size_t)nthreads, sizeof(js_worker_t));
+    js_worker_t *workers = bench_workers_alloc(config, nthreads, nprocs > 1);
+    if (!workers) {
+        fprintf(stderr, "Error: out of memory\n");
+        return 1;
+    }
 
     /* Distribute connections across threads */
     int conns_per_thread = nconns / nthreads;
     int extra_conns = nconns % nthreads;
 
+    int conn_base = 0;
+
     for (int i = 0; i < nthreads; i++) {
         workers[i].id = i;
         workers[i].config = config;
         workers[i].conn_count = conns_per_thread + (i < extra_conns ? 1 : 0);
+        workers[i].conn_base = conn_base;
+        workers[i].nworkers = nthreads;
+        conn_base += workers[i].conn_count;
         atomic_init(&workers[i].stop, false);
+        atomic_init(&workers[i].snap_step, 0);
+        workers[i].addr_seed = (unsigned) (js_now_ns() ^ (uint64_t) (i + 1));
+
+        if (config->search) {
+            workers[i].snapshot = malloc(sizeof(js_stats_t));
+            if (!workers[i].snapshot) {
+                fprintf(stderr, "Error: out of memory\n");
+                for (int k = 0; k < i; k++) free(workers[k].snapshot);
+                free(workers);
+                return 1;
+            }
+        }
+    }
+
+    /*
+     * With preconnect, workers open their connections first and the clock
+     * starts once every one of them has reached the barrier.  Replay and
+     * fetch() open connections on demand, so it only applies to the C path.
+     */
+    pthread_barrier_t local_barrier, *barrier = &local_barrier;
+    bool preconnect = config->preconnect && !config->replay &&
+                      !config->search && config->mode != MODE_BENCH_ASYNC;
+
+    if (preconnect) {
+        pthread_barrierattr_t attr;
+        pthread_barrierattr_init(&attr);
+
+        if (nprocs > 1) {
+            barrier = bench_shared_alloc(sizeof(pthread_barrier_t));
+            if (!barrier) {
+                fprintf(stderr, "Error: out of memory\n");
+                bench_workers_free(config, workers, nthreads, true);
+                return 1;
+            }
+            pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        }
+
+        pthread_barrier_init(barrier, &attr, (unsigned) nthreads + 1);
+        pthread_barrierattr_destroy(&attr);
+        for (int i = 0; i < nthreads; i++) workers[i].barrier = barrier;
+    }
+
+    /* Distributed run: every agent starts at the coordinator's instant */
+    if (config->remote && config->remote->start_at_ns) {
+        struct timespec at = {
+            .tv_sec = (time_t) (config->remote->start_at_ns / 1000000000ULL),
+            .tv_nsec = (long) (config->remote->start_at_ns % 1000000000ULL),
+        };
+
+        while (clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &at, NULL) == EINTR) { }
     }
 
     /* Start timing */
     uint64_t start_ns = js_now_ns();
+    double cpu_user, cpu_sys;
+
+    bench_cpu_time(&cpu_user, &cpu_sys);
+
+    /* Launch worker threads, or processes that each run a share of them */
+    pid_t pids[nprocs];
+    int ret = 0;
 
-    /* Launch worker threads */
     for (int i = 0; i < nthreads; i++) {
-        pthread_create(&workers[i].thread, NULL, js_worker_run, &workers[i]);
+        if (!preconnect) workers[i].start_ns = start_ns;
     }
 
-    /* Wait for all workers */
-    for (int i = 0; i < nthreads; i++) {
-        pthread_join(workers[i].thread, NULL);
+    if (nprocs > 1) {
+        if (bench_fork(workers, nthreads, pids, nprocs) != 0) {
+            ret = 1;
+            goto done;
+        }
+    } else {
+        for (int i = 0; i < nthreads; i++)
+            pthread_create(&workers[i].thread, NULL, js_worker_run, &workers[i]);
     }
 
-    uint64_t end_ns = js_now_ns();
-    double actual_duration = (double)(end_ns - start_ns) / 1e9;
+    if (preconnect) {
+        pthread_barrier_wait(barrier);
+
+        uint64_t setup_ns = js_now_ns();
+        int connected = 0;
+        char setup_buf[32];
 
-    /* Aggregate stats */
-    js_stats_t total;
+        for (int i = 0; i < nthreads; i++) connected += workers[i].connected;
+
+        js_format_duration((double)(setup_ns - start_ns) / 1000.0,
+                           setup_buf, sizeof(setup_buf));
+        printf("Setup: %d of %d connection(s) in %s\n",
+               connected, nconns, setup_buf);
+        fflush(stdout);
+
+        start_ns = setup_ns;
+    }
+
+    js_stats_t total, chosen;
+    double chosen_window = 0;
     js_stats_init(&total);
+
+    if (config->search) {
+        /*
+         * Throughput search: drive the workers step by step, then stop
+         * them.  The search prints its own steps and result; the client
+         * reports below cover the whole search.
+         */
+        js_search_run(config, workers, nthreads, &total, &chosen,
+                      &chosen_window);
+
+        for (int i = 0; i < nthreads; i++) {
+            atomic_store(&workers[i].stop, true);
+            pthread_join(workers[i].thread, NULL);
+            free(workers[i].snapshot);
+            js_stats_merge(&total, &workers[i].stats);
+        }
+    } else if (nprocs > 1) {
+        /* Wait for all workers */
+        if (bench_wait(pids, nprocs) != 0) {
+            ret = 1;
+            goto done;
+        }
+    } else {
+        for (int i = 0; i < nthreads; i++)
+            pthread_join(workers[i].thread, NULL);
+    }
+
+    uint64_t end_ns = js_now_ns();
+
+    /* Only the measured window counts: it starts when warmup ends */
+    uint64_t measure_ns = end_ns;
     for (int i = 0; i < nthreads; i++) {
-        js_stats_merge(&total, &workers[i].stats);
+        if (workers[i].measure_ns && workers[i].measure_ns < measure_ns)
+            measure_ns = workers[i].measure_ns;
     }
+    double actual_duration = (double)(end_ns - measure_ns) / 1e9;
 
-    /* Print results */
-    js_stats_print(&total, actual_duration);
+    if (!config->search) {
+        /* Aggregate stats */
+        for (int i = 0; i < nthreads; i++) {
+            js_stats_merge(&total, &workers[i].stats);
+        }
 
+        /* Print results */
+        js_stats_print(&total, actual_duration);
+        if (config->naddrs > 1) bench_print_addrs(config, workers, nthreads);
+    }
+
+    if (config->tcpinfo_ms > 0) bench_print_tcpinfo(config, workers, nthreads);
+
+    if (config->sockopts.fast_open) {
+        uint64_t tried = 0, accepted = 0;
+        for (int i = 0; i < nthreads; i++) {
+            tried += workers[i].fastopen_conns;
+            accepted += workers[i].fastopen;
+        }
+
+        printf("  fastopen   %lu of %lu connection(s) had the request "
+               "accepted in the SYN\n\n",
+               (unsigned long)accepted, (unsigned long)tried);
+    }
+
+    if (config->use_tls && config->tls.ktls && !js_tls_ktls_available()) {
+        printf("  ktls       unavailable, OpenSSL was built without kTLS\n\n");
+
+    } else if (config->use_tls && config->tls.ktls) {
+        uint64_t conns = 0, tx = 0, rx = 0;
+        for (int i = 0; i < nthreads; i++) {
+            conns += workers[i].tls_conns;
+            tx += workers[i].ktls_tx;
+            rx += workers[i].ktls_rx;
+        }
+
+        printf("  ktls       tx on %lu, rx on %lu of %lu TLS connection(s)\n\n",
+               (unsigned long)tx, (unsigned long)rx, (unsigned long)conns);
+    }
+
+    if (config->timestamps != JS_TSTAMP_NONE && config->use_tls) {
+        printf("  timestamps unsupported on TLS connections\n\n");
+    } else if (config->timestamps != JS_TSTAMP_NONE) {
+        bench_print_timestamps(workers, nthreads, total.requests);
+    }
+
+    bench_print_self(workers, nthreads, total.requests, config->busy_poll);
+    if (config->stats_verbose) bench_print_verbose(workers, nthreads, &total);
+    if (config->perf) bench_print_perf(workers, nthreads, total.requests);
+
+    /* Busy polling trades CPU for latency: show what it cost */
+    if (config->busy_poll) {
+        double user, sys;
+        double wall = (double)(end_ns - start_ns) / 1e9;
+
+        bench_cpu_time(&user, &sys);
+        user -= cpu_user;
+        sys -= cpu_sys;
+
+        printf("  cpu        user      sys       cores\n");
+        printf("             %-10.2f%-10.2f%-10.2f\n", user, sys,
+               wall > 0 ? (user + sys) / wall : 0);
+        printf("\n");
+    }
+
+    /* A search hands on the step it settled on, not the sum of its steps */
+    if (config->remote && config->search) {
+        config->remote->stats = chosen;
+        config->remote->duration_sec = chosen_window;
+    } else if (config->remote) {
+        config->remote->stats = total;
+        config->remote->duration_sec = actual_duration;
+    }
+
+done:
     /* Cleanup */
-    free(workers);
-    if (config->ssl_ctx) {
-        SSL_CTX_free(config->ssl_ctx);
-        config->ssl_ctx = NULL;
+    if (preconnect) {
+        pthread_barrier_destroy(barrier);
+        if (barrier != &local_barrier) munmap(barrier, sizeof(pthread_barrier_t));
     }
+    bench_workers_free(config, workers, nthreads, nprocs > 1);
 
-    return 0;
+    return ret;
+}
+
+/* ── Run a script ─────────────────────────────────────────────────────── */
+
+/*
+ * Evaluate the script and run it: as a plain script, or as a benchmark
+ * when it has a default export.  Takes ownership of source.  With remote
+ * set (agent mode), the run starts at remote->start_at_ns and the merged
+ * results are left in remote.
+ */
+int js_runtime_run_script(const char *script_path, char *source,
+                          js_bench_result_t *remote) {
+    /* Create engine and event loop (fetch() needs them during module evaluation) */
+    js_engine_t *engine = js_engine_create();
+    if (!engine) {
+        fprintf(stderr, "Error: failed to create engine\n");
+        free(source);
+        return 1;
+    }
+    js_thread()->engine = engine;
+
+    js_loop_t *loop = js_loop_create();
+    if (!loop) {
+        fprintf(stderr, "Error: failed to create event loop\n");
+        js_engine_destroy(engine);
+        free(source);
+        return 1;
+    }
+
+    /* Initialize QuickJS */
+    JSContext *ctx = js_vm_create();
+    if (!ctx) {
+        fprintf(stderr, "Error: failed to create JS context\n");
+        js_loop_free(loop);
+        js_engine_destroy(engine);
+        free(source);
+        return 1;
+    }
+    JS_SetContextOpaque(ctx, loop);
+
+    /* Evaluate the module */
+    JSValue default_export, bench_export;
+    if (js_vm_eval_module(ctx, script_path, source, &default_export, &bench_export) != 0) {
+        JS_SetContextOpaque(ctx, NULL);
+        js_loop_free(loop);
+        js_vm_free(ctx);
+        free(source);
+        return 1;
+    }
+
+    /* Detect mode */
+    js_mode_t mode = js_runtime_detect_mode(ctx, default_export);
+
+    /* Build config */
+    js_config_t config = {0};
+    config.mode = mode;
+    config.script_path = strdup(script_path);
+    config.script_source = source;
+    config.connections = 1;
+    config.threads = 1;
+    config.duration_sec = 0;
+    config.sockopts.nodelay = true;
+    config.tls.resume = true;
+
+    int ret = 0;
+
+    if (mode != MODE_CLI) {
+        /* Benchmark mode: extract config and requests */
+        if (js_runtime_extract_config(ctx, bench_export, &config) != 0) {
+            ret = 1;
+            goto cleanup;
+        }
+
+        if (mode != MODE_BENCH_ASYNC) {
+            /* Extract and serialize requests for C-path */
+            if (js_runtime_extract_requests(ctx, default_export, &config) != 0) {
+                fprintf(stderr, "Error: failed to extract request configuration\n");
+                ret = 1;
+                goto cleanup;
+            }
+
+            if (config.request_count == 0 && !config.reqfile && !config.replay) {
+                fprintf(stderr, "Error: no valid requests found\n");
+                ret = 1;
+                goto cleanup;
+            }
+        } else {
+            /* For async mode, we need at least a dummy request for DNS resolution */
+            /* The actual requests happen in JS */
+            /* We need to figure out the target URL for DNS */
+            if (!config.target) {
+                fprintf(stderr, "Error: async function mode requires 'target' in bench config,\n"
+                               "       or the function must use full URLs in fetch() calls.\n"
+                               "       Proceeding with localhost assumption...\n");
+            }
+
+            /* Create a minimal request entry for the orchestrator */
+            config.request_count = 1;
+            config.requests = calloc(1, sizeof(js_buf_t));
+            if (config.target) {
+                js_parse_url(config.target, &config.url);
+                config.use_tls = config.url.is_tls;
+            }
+        }
+
+        /* A replay or search runs until it is done */
+        if (config.duration_sec <= 0 && !config.replay && !config.search) {
+            config.duration_sec = 10.0;  /* default 10 seconds */
+        }
+
+        config.mode = mode;
+        config.remote = remote;
+        ret = js_bench_run(&config);
+    }
+
+cleanup:
+    /* Free resources */
+    JS_SetContextOpaque(ctx, NULL);
+    js_loop_free(loop);
+    JS_FreeValue(ctx, default_export);
+    JS_FreeValue(ctx, bench_export);
+    js_vm_free(ctx);
+    js_engine_destroy(engine);
+
+    for (int i = 0; i < config.request_count; i++) {
+        js_buf_free(&config.requests[i]);
+        if (config.templates) js_template_free(&config.templates[i]);
+        if (config.bodies) js_body_close(&config.bodies[i]);
+    }
+    free(config.requests);
+    free(config.templates);
+    free(config.bodies);
+    js_reqfile_close(config.reqfile);
+    js_replay_free(config.replay);
+    free(config.search);
+    free(config.addrs);
+    for (int i = 0; i < config.nresolve; i++) free(config.resolve[i]);
+    free(config.resolve);
+    free(config.target);
+    free(config.host);
+    free(config.script_path);
+    free(config.script_source);
+
+    return ret;
 }
@@ -6,6 +6,8 @@
 #define JS_MAX_CONNECTIONS  65536
 #define JS_MAX_THREADS      256
 #define JS_READ_BUF_SIZE    16384
+#define JS_MAX_ADDRS        64
+#define JS_SATURATED        0.9     /* share of a core: client-bound */
 
 /* ── Benchmark mode ───────────────────────────────────────────────────── */
 
@@ -17,13 +19,62 @@ typedef enum {
     MODE_BENCH_ASYNC     /* default export is an async function */
 } js_mode_t;
 
-/* ── Benchmark configuration ──────────────────────────────────────────── */
+/* ── Target addresses ───────────────────────────────────────────────── */
+
+typedef enum {
+    JS_ADDR_FIRST,       /* all connections to the first address */
+    JS_ADDR_ROUNDROBIN,  /* connection n to address n % naddrs */
+    JS_ADDR_RANDOM       /* each connection to a random address */
+} js_addr_policy_t;
 
 typedef struct {
+    struct sockaddr_storage  sa;
+    socklen_t                len;
+    char                     name[64];    /* "ip:port", for reports */
+} js_addr_t;
+
+/* ── Results of a run driven by a coordinator ─────────────────────────── */
+
+typedef struct js_bench_result_s {
+    /*
+     * Called once the script is loaded and the run set up, with how long
+     * the run will take (0: not known, e.g. replay or search); sets start_at_ns
+     */
+    int       (*ready)(struct js_bench_result_s *res, double run_sec);
+    void       *data;            /* for ready */
+
+    uint64_t    start_at_ns;     /* CLOCK_REALTIME instant to start at */
+    js_stats_t  stats;           /* merged over all workers */
+    double      duration_sec;    /* measured window */
+} js_bench_result_t;
+
+/* ── Benchmark configuration ──────────────────────────────────────────── */
+
+typedef enum {
+    JS_TSTAMP_NONE,
+    JS_TSTAMP_SOFTWARE
+} js_tstamp_t;
+
+typedef struct js_config_s {
     /* From script */
     int         connections;
     int         threads;
+    int         processes;       /* fork, and split threads over them */
     double      duration_sec;
+    double      warmup_sec;      /* run before stats are kept */
+    bool        preconnect;      /* connect everything before timing */
+    int         max_requests;    /* reconnect after this many, 0: never */
+    bool        reset_on_close;  /* close with RST (SO_LINGER 0) */
+    bool        busy_poll;       /* spin on epoll_wait, never sleep */
+    int         busy_poll_us;    /* SO_BUSY_POLL on sockets, 0: off */
+    js_tstamp_t timestamps;      /* latency from kernel timestamps */
+    int         tcpinfo_ms;      /* TCP_INFO sampling period, 0: off */
+    bool        stats_verbose;   /* per-worker hot-path counters */
+    bool        perf;            /* hardware counters per worker */
+    js_sockopts_t sockopts;      /* bench.socket */
+    js_tlsopts_t  tls;           /* bench.tls */
+    js_search_t *search;         /* find the highest rate within an SLO */
+    js_bench_result_t *remote;   /* agent mode: report back, not just print */
     char       *target;          /* Override base URL */
     char       *host;            /* Override Host header */
 
@@ -37,22 +88,68 @@ typedef struct {
 
     /* Pre-built requests (C-path) */
     js_buf_t   *requests;
+    js_template_t *templates;    /* parallel to requests */
+    js_body_t     *bodies;       /* parallel to requests, fd -1: in-memory */
     int         request_count;
 
-    /* Resolved address */
-    struct sockaddr_storage addr;
-    socklen_t               addr_len;
+    /* Requests streamed from a file instead (C-path) */
+    js_reqfile_t *reqfile;
+
+    /* Or replayed on their original schedule (C-path) */
+    js_replay_t  *replay;
 
-    /* TLS */
+    /* Resolved addresses, or bench.resolve */
+    js_addr_t        *addrs;
+    int               naddrs;
+    js_addr_policy_t  addr_policy;
+    char            **resolve;
+    int               nresolve;
+
+    /* TLS; each worker creates its own SSL_CTX from bench.tls */
     bool        use_tls;
-    SSL_CTX    *ssl_ctx;
 } js_config_t;
 
 /* ── Worker thread context ────────────────────────────────────────────── */
 
-typedef struct {
+typedef struct js_worker_s {
     int             id;
     int             conn_count;      /* connections assigned to this worker */
+    int             conn_base;       /* number of the first connection */
+    int             nworkers;
+    js_tpl_vars_t   tpl;
+    int             file_cursor;     /* next record of config->reqfile */
+    uint64_t        start_ns;        /* run start; replay entry offset 0 */
+    uint64_t        measure_ns;      /* start of the measured window */
+    int             connected;       /* preconnect: connections set up */
+    pthread_barrier_t *barrier;      /* preconnect: start together */
+    void           *sched;           /* replay/rate: worker-private state */
+    atomic_int      snap_step;       /* search: last step handed over */
+    js_stats_t     *snapshot;        /* search: stats of that step */
+    js_addr_stats_t *addr_stats;     /* per address, if more than one */
+    js_hist_t      *kernel_latency;  /* bench.timestamps: kernel-timed TTFB */
+    js_tcpinfo_t   *tcpinfo;         /* bench.tcpInfo samples, if enabled */
+    uint64_t        fastopen_conns;  /* fast open: connections tried */
+    uint64_t        fastopen;        /* ... whose SYN data was accepted */
+    SSL_CTX        *ssl_ctx;         /* private: no shared locks */
+    SSL_SESSION   **sessions;        /* per address, resumed on reconnect */
+    uint64_t        tls_conns;       /* TLS handshakes completed */
+    uint64_t        ktls_tx;         /* ... with kTLS sending */
+    uint64_t        ktls_rx;         /* ... with kTLS receiving */
+    unsigned        addr_seed;       /* random address policy */
+
+    /*
+     * The worker's own cost.  CPU time is the thread's (RUSAGE_THREAD)
+     * over cpu_ns of wall time; until the worker ends, the three hold
+     * where the measured window started.
+     */
+    double          cpu_user;
+    double          cpu_sys;
+    uint64_t        cpu_ns;
+    uint64_t        wakeups;         /* epoll_wait() returns with events */
+    uint64_t        events;          /* events dispatched */
+    js_hist_t      *loop_lag;        /* us from wakeup to end of the turn */
+    js_counters_t   counters;        /* hot-path counts, as with the CPU */
+    js_perf_t       perf;            /* bench.perf, as with the CPU */
     js_config_t   *config;
     js_stats_t     stats;
     pthread_t       thread;
@@ -65,6 +162,9 @@ int         js_runtime_extract_config(JSContext *ctx, JSValue bench_export,
 int         js_runtime_extract_requests(JSContext *ctx, JSValue default_export,
                                          js_config_t *config);
 
+int   js_runtime_run_script(const char *script_path, char *source,
+                            js_bench_result_t *remote);
+
 int   js_bench_run(js_config_t *config);
 void *js_worker_run(void *arg);
 
@@ -0,0 +1,138 @@
+#include "js_main.h"
+
+#define SEARCH_MAX_STEPS   24
+#define SEARCH_PRECISION   0.05     /* stop once the bracket is within 5% */
+#define SEARCH_MIN_ACHIEVED 0.9     /* share of the target rate to reach */
+
+static void search_sleep(double sec) {
+    struct timespec ts;
+
+    ts.tv_sec = (time_t) sec;
+    ts.tv_nsec = (long) ((sec - (double) ts.tv_sec) * 1e9);
+
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) { }
+}
+
+/*
+ * Start a new step and wait until every worker has handed over its stats
+ * for the previous one.  A worker that does not answer within a second is
+ * assumed gone and left out.
+ */
+static int search_sync(js_search_t *s, js_worker_t *workers, int n) {
+    int step = atomic_fetch_add(&s->step, 1) + 1;
+    uint64_t deadline = js_now_ns() + 1000000000ULL;
+
+    for (int i = 0; i < n; i++) {
+        while (atomic_load(&workers[i].snap_step) != step &&
+               js_now_ns() < deadline)
+        {
+            search_sleep(0.001);
+        }
+    }
+
+    return step;
+}
+
+/* Add the snapshots handed over for step to out */
+static void search_collect(js_worker_t *workers, int n, int step,
+                           js_stats_t *out) {
+    for (int i = 0; i < n; i++) {
+        if (atomic_load(&workers[i].snap_step) == step)
+            js_stats_merge(out, workers[i].snapshot);
+    }
+}
+
+/*
+ * Run one step at rate; returns the merged stats and the measured window.
+ * Everything recorded, the switch included, is also added to all.
+ */
+static double search_step(js_search_t *s, js_worker_t *workers, int n,
+                          double rate, js_stats_t *out, js_stats_t *all) {
+    /* Switch rate; whatever was recorded during the switch is dropped */
+    s->rate = rate;
+    search_collect(workers, n, search_sync(s, workers, n), all);
+
+    uint64_t start_ns = js_now_ns();
+    search_sleep(s->step_sec);
+    int step = search_sync(s, workers, n);
+    uint64_t end_ns = js_now_ns();
+
+    js_stats_init(out);
+    search_collect(workers, n, step, out);
+    js_stats_merge(all, out);
+
+    return (double) (end_ns - start_ns) / 1e9;
+}
+
+int js_search_run(js_config_t *config, js_worker_t *workers, int nworkers,
+                  js_stats_t *all, js_stats_t *best, double *best_window) {
+    js_search_t *s = config->search;
+    js_stats_t step_stats;
+    double lo = 0, hi = 0;
+    double rate = s->start_rate;
+    char slo_buf[32];
+
+    js_stats_init(best);
+    *best_window = 0;
+    js_format_duration(s->p99_us, slo_buf, sizeof(slo_buf));
+
+    printf("  rate      achieved  p50       p99       errors\n");
+
+    for (int k = 0; k < SEARCH_MAX_STEPS; k++) {
+        double window = search_step(s, workers, nworkers, rate, &step_stats,
+                                    all);
+
+        uint64_t total = step_stats.requests + step_stats.errors;
+        double achieved = window > 0 ? (double) step_stats.requests / window : 0;
+        double err = total ? (double) step_stats.errors / (double) total : 0;
+        double p50 = js_hist_percentile(&step_stats.latency, 50);
+        double p99 = js_hist_percentile(&step_stats.latency, 99);
+
+        bool ok = step_stats.requests > 0 &&
+                  p99 <= s->p99_us &&
+                  err <= s->error_rate &&
+                  achieved >= rate * SEARCH_MIN_ACHIEVED;
+
+        char p50_buf[32], p99_buf[32], err_buf[32];
+        js_format_duration(p50, p50_buf, sizeof(p50_buf));
+        js_format_duration(p99, p99_buf, sizeof(p99_buf));
+        snprintf(err_buf, sizeof(err_buf), "%.2f%%", err * 100);
+
+        printf("  %-10.0f%-10.1f%-10s%-10s%-10s%s\n",
+               rate, achieved, p50_buf, p99_buf, err_buf,
+               ok ? "ok" : "over");
+        fflush(stdout);
+
+        if (ok) {
+            lo = rate;
+            *best = step_stats;
+            *best_window = window;
+        } else {
+            hi = rate;
+        }
+
+        /* Double until the SLO is missed, then bisect */
+        if (hi == 0) {
+            if (rate >= s->max_rate) break;
+            rate = rate * 2 < s->max_rate ? rate * 2 : s->max_rate;
+        } else {
+            if (hi - lo <= hi * SEARCH_PRECISION) break;
+            rate = (lo + hi) / 2;
+            if (rate < 1) break;
+        }
+    }
+
+    printf("\n");
+
+    if (lo == 0) {
+        printf("  no rate met p99 <= %s, errors <= %.2f%%\n",
+               slo_buf, s->error_rate * 100);
+        return 0;
+    }
+
+    printf("  max rate:  %.0f req/s (p99 <= %s, errors <= %.2f%%)\n",
+           lo, slo_buf, s->error_rate * 100);
+
+    js_stats_print(best, *best_window);
+    return 0;
+}
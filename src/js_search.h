@@ -0,0 +1,34 @@
+#ifndef JS_SEARCH_H
+#define JS_SEARCH_H
+
+/* ── Throughput search ────────────────────────────────────────────────── */
+
+/*
+ * Settings for bench.search, and the channel the controller thread uses
+ * to drive rate-paced workers between steps.  The controller writes rate,
+ * then bumps step; each worker answers by handing over its stats for the
+ * step that ended and switching to the new rate.
+ */
+
+typedef struct {
+    double      p99_us;          /* latency SLO */
+    double      error_rate;      /* highest errors / requests allowed */
+    double      step_sec;        /* length of each measured step */
+    double      start_rate;      /* first rate tried, requests/s */
+    double      max_rate;
+
+    double      rate;            /* current rate, all workers */
+    atomic_int  step;
+} js_search_t;
+
+typedef struct js_config_s js_config_t;
+typedef struct js_worker_s js_worker_t;
+
+/*
+ * Every step recorded is added to all; the step the search settled on is
+ * left in best, with its measured window.
+ */
+int js_search_run(js_config_t *config, js_worker_t *workers, int nworkers,
+                  js_stats_t *all, js_stats_t *best, double *best_window);
+
+#endif /* JS_SEARCH_H */
@@ -77,6 +77,8 @@ double js_hist_stdev(const js_hist_t *h) {
 void js_stats_init(js_stats_t *s) {
     memset(s, 0, sizeof(*s));
     js_hist_init(&s->latency);
+    js_hist_init(&s->connect_latency);
+    js_hist_init(&s->handshake_latency);
 }
 
 void js_stats_merge(js_stats_t *dst, const js_stats_t *src) {
@@ -91,6 +93,23 @@ void js_stats_merge(js_stats_t *dst, const js_stats_t *src) {
     dst->status_3xx += src->status_3xx;
     dst->status_4xx += src->status_4xx;
     dst->status_5xx += src->status_5xx;
+    dst->connects += src->connects;
+    dst->handshakes += src->handshakes;
+    dst->handshakes_resumed += src->handshakes_resumed;
+    js_hist_merge(&dst->latency, &src->latency);
+    js_hist_merge(&dst->connect_latency, &src->connect_latency);
+    js_hist_merge(&dst->handshake_latency, &src->handshake_latency);
+}
+
+void js_addr_stats_init(js_addr_stats_t *s) {
+    s->requests = 0;
+    s->errors = 0;
+    js_hist_init(&s->latency);
+}
+
+void js_addr_stats_merge(js_addr_stats_t *dst, const js_addr_stats_t *src) {
+    dst->requests += src->requests;
+    dst->errors += src->errors;
     js_hist_merge(&dst->latency, &src->latency);
 }
 
@@ -134,4 +153,204 @@ void js_stats_print(const js_stats_t *s, double duration_sec) {
            (unsigned long)s->status_2xx, (unsigned long)s->status_3xx,
            (unsigned long)s->status_4xx, (unsigned long)s->status_5xx);
     printf("\n");
+
+    /* Connection setup, when connections were opened in the window */
+    if (s->connects == 0) return;
+
+    double cps = duration_sec > 0 ? (double)s->connects / duration_sec : 0;
+
+    js_format_duration(js_hist_percentile(&s->connect_latency, 50),
+                       p50_buf, sizeof(p50_buf));
+    js_format_duration(js_hist_percentile(&s->connect_latency, 99),
+                       p99_buf, sizeof(p99_buf));
+
+    printf("  connect    count     per sec   p50       p99\n");
+    printf("             %-10lu%-10.1f%-10s%-10s\n",
+           (unsigned long)s->connects, cps, p50_buf, p99_buf);
+    printf("\n");
+
+    if (s->handshakes == 0) return;
+
+    js_format_duration(js_hist_percentile(&s->handshake_latency, 50),
+                       p50_buf, sizeof(p50_buf));
+    js_format_duration(js_hist_percentile(&s->handshake_latency, 99),
+                       p99_buf, sizeof(p99_buf));
+
+    printf("  tls        full      resumed   per sec   p50       p99\n");
+    printf("             %-10lu%-10lu%-10.1f%-10s%-10s\n",
+           (unsigned long)(s->handshakes - s->handshakes_resumed),
+           (unsigned long)s->handshakes_resumed,
+           duration_sec > 0 ? (double)s->handshakes / duration_sec : 0,
+           p50_buf, p99_buf);
+    printf("\n");
+}
+
+/* ── Serialization ────────────────────────────────────────────────────── */
+
+/*
+ * Portable encoding for shipping stats between processes and hosts:
+ * big-endian integers, doubles as their IEEE 754 bit pattern, and only
+ * the non-empty histogram slots as (index, count) pairs.  Decoding and
+ * merging gives exactly what merging the original would.
+ */
+
+#define STATS_WIRE_VERSION  2
+
+static void stats_put_u32(uint8_t **p, uint32_t v) {
+    for (int i = 3; i >= 0; i--) *(*p)++ = (uint8_t)(v >> (i * 8));
+}
+
+static void stats_put_u64(uint8_t **p, uint64_t v) {
+    for (int i = 7; i >= 0; i--) *(*p)++ = (uint8_t)(v >> (i * 8));
+}
+
+static void stats_put_f64(uint8_t **p, double d) {
+    uint64_t v;
+    memcpy(&v, &d, sizeof(v));
+    stats_put_u64(p, v);
+}
+
+static uint32_t stats_get_u32(const uint8_t **p) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v = (v << 8) | *(*p)++;
+    return v;
+}
+
+static uint64_t stats_get_u64(const uint8_t **p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v = (v << 8) | *(*p)++;
+    return v;
+}
+
+static double stats_get_f64(const uint8_t **p) {
+    uint64_t v = stats_get_u64(p);
+    double d;
+    memcpy(&d, &v, sizeof(d));
+    return d;
+}
+
+#define STATS_WIRE_COUNTERS  14
+#define STATS_WIRE_HIST      (2 * 8 + 4 * 8 + 4)   /* before the slots */
+#define STATS_WIRE_SLOT      12
+
+static uint32_t stats_hist_slots(const js_hist_t *h) {
+    uint32_t n = 0;
+
+    for (int i = 0; i < HIST_TOTAL_SLOTS; i++) {
+        if (h->slots[i]) n++;
+    }
+    return n;
+}
+
+static void stats_put_hist(uint8_t **p, const js_hist_t *h, uint32_t nslots) {
+    stats_put_u64(p, h->over);
+    stats_put_u64(p, h->count);
+    stats_put_f64(p, h->sum);
+    stats_put_f64(p, h->sum_sq);
+    stats_put_f64(p, h->min_val);
+    stats_put_f64(p, h->max_val);
+    stats_put_u32(p, nslots);
+
+    for (uint32_t i = 0; i < HIST_TOTAL_SLOTS; i++) {
+        if (h->slots[i] == 0) continue;
+        stats_put_u32(p, i);
+        stats_put_u64(p, h->slots[i]);
+    }
+}
+
+static int stats_get_hist(const uint8_t **p, const uint8_t *end,
+                          js_hist_t *h) {
+    if (end - *p < STATS_WIRE_HIST) return -1;
+
+    h->over = stats_get_u64(p);
+    h->count = stats_get_u64(p);
+    h->sum = stats_get_f64(p);
+    h->sum_sq = stats_get_f64(p);
+    h->min_val = stats_get_f64(p);
+    h->max_val = stats_get_f64(p);
+
+    uint32_t nslots = stats_get_u32(p);
+    if (nslots > HIST_TOTAL_SLOTS ||
+        (size_t)(end - *p) < (size_t)nslots * STATS_WIRE_SLOT)
+        return -1;
+
+    for (uint32_t i = 0; i < nslots; i++) {
+        uint32_t slot = stats_get_u32(p);
+        uint64_t count = stats_get_u64(p);
+        if (slot >= HIST_TOTAL_SLOTS) return -1;
+        h->slots[slot] = count;
+    }
+
+    return 0;
+}
+
+int js_stats_encode(const js_stats_t *s, js_buf_t *out) {
+    const js_hist_t *hists[] = {
+        &s->latency, &s->connect_latency, &s->handshake_latency
+    };
+    uint32_t nslots[3];
+    size_t len = 4 + STATS_WIRE_COUNTERS * 8;
+
+    for (int i = 0; i < 3; i++) {
+        nslots[i] = stats_hist_slots(hists[i]);
+        len += STATS_WIRE_HIST + (size_t)nslots[i] * STATS_WIRE_SLOT;
+    }
+
+    if (js_buf_ensure(out, out->len + len) < 0) return -1;
+
+    uint8_t *p = (uint8_t *)out->data + out->len;
+
+    stats_put_u32(&p, STATS_WIRE_VERSION);
+    stats_put_u64(&p, s->requests);
+    stats_put_u64(&p, s->bytes_read);
+    stats_put_u64(&p, s->errors);
+    stats_put_u64(&p, s->connect_errors);
+    stats_put_u64(&p, s->read_errors);
+    stats_put_u64(&p, s->write_errors);
+    stats_put_u64(&p, s->timeout_errors);
+    stats_put_u64(&p, s->status_2xx);
+    stats_put_u64(&p, s->status_3xx);
+    stats_put_u64(&p, s->status_4xx);
+    stats_put_u64(&p, s->status_5xx);
+    stats_put_u64(&p, s->connects);
+    stats_put_u64(&p, s->handshakes);
+    stats_put_u64(&p, s->handshakes_resumed);
+
+    for (int i = 0; i < 3; i++) stats_put_hist(&p, hists[i], nslots[i]);
+
+    out->len += len;
+    return 0;
+}
+
+int js_stats_decode(js_stats_t *s, const char *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    const uint8_t *end = p + len;
+
+    if (len < 4 + STATS_WIRE_COUNTERS * 8) return -1;
+
+    js_stats_init(s);
+
+    if (stats_get_u32(&p) != STATS_WIRE_VERSION) return -1;
+
+    s->requests = stats_get_u64(&p);
+    s->bytes_read = stats_get_u64(&p);
+    s->errors = stats_get_u64(&p);
+    s->connect_errors = stats_get_u64(&p);
+    s->read_errors = stats_get_u64(&p);
+    s->write_errors = stats_get_u64(&p);
+    s->timeout_errors = stats_get_u64(&p);
+    s->status_2xx = stats_get_u64(&p);
+    s->status_3xx = stats_get_u64(&p);
+    s->status_4xx = stats_get_u64(&p);
+    s->status_5xx = stats_get_u64(&p);
+    s->connects = stats_get_u64(&p);
+    s->handshakes = stats_get_u64(&p);
+    s->handshakes_resumed = stats_get_u64(&p);
+
+    if (stats_get_hist(&p, end, &s->latency) != 0 ||
+        stats_get_hist(&p, end, &s->connect_latency) != 0 ||
+        stats_get_hist(&p, end, &s->handshake_latency) != 0)
+        return -1;
+
+    return 0;
 }
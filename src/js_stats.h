@@ -34,9 +34,23 @@ typedef struct {
     uint64_t   status_3xx;
     uint64_t   status_4xx;
     uint64_t   status_5xx;
+    uint64_t   connects;             /* TCP connections set up */
+    uint64_t   handshakes;           /* TLS handshakes completed */
+    uint64_t   handshakes_resumed;   /* of which resumed a session */
     js_hist_t latency;
+    js_hist_t connect_latency;       /* connect() to connected */
+    js_hist_t handshake_latency;     /* connected to TLS finished */
 } js_stats_t;
 
+/* ── Per-address stats ────────────────────────────────────────────────── */
+
+/* Only what the per-address report shows: no setup histograms */
+typedef struct {
+    uint64_t   requests;
+    uint64_t   errors;
+    js_hist_t  latency;
+} js_addr_stats_t;
+
 void    js_hist_init(js_hist_t *h);
 void    js_hist_add(js_hist_t *h, double us);
 void    js_hist_merge(js_hist_t *dst, const js_hist_t *src);
@@ -46,5 +60,9 @@ double  js_hist_stdev(const js_hist_t *h);
 void    js_stats_init(js_stats_t *s);
 void    js_stats_merge(js_stats_t *dst, const js_stats_t *src);
 void    js_stats_print(const js_stats_t *s, double duration_sec);
+int     js_stats_encode(const js_stats_t *s, js_buf_t *out);
+int     js_stats_decode(js_stats_t *s, const char *data, size_t len);
+void    js_addr_stats_init(js_addr_stats_t *s);
+void    js_addr_stats_merge(js_addr_stats_t *dst, const js_addr_stats_t *src);
 
 #endif /* JS_STATS_H */
@@ -0,0 +1,74 @@
+#include "js_main.h"
+
+void js_tcpinfo_init(js_tcpinfo_t *t) {
+    memset(t, 0, sizeof(*t));
+    js_hist_init(&t->rtt);
+    js_hist_init(&t->rttvar);
+    js_hist_init(&t->cwnd);
+    js_hist_init(&t->unacked);
+}
+
+int js_tcpinfo_get(int fd, struct tcp_info *ti) {
+    socklen_t len = sizeof(*ti);
+
+    if (fd < 0) return -1;
+    return getsockopt(fd, IPPROTO_TCP, TCP_INFO, ti, &len);
+}
+
+void js_tcpinfo_add(js_tcpinfo_t *t, const struct tcp_info *ti) {
+    t->samples++;
+    js_hist_add(&t->rtt, ti->tcpi_rtt);
+    js_hist_add(&t->rttvar, ti->tcpi_rttvar);
+    js_hist_add(&t->cwnd, ti->tcpi_snd_cwnd);
+    js_hist_add(&t->unacked, ti->tcpi_unacked);
+}
+
+/* ── Slowest responses ────────────────────────────────────────────────── */
+
+bool js_tcpinfo_is_slow(const js_tcpinfo_t *t, double latency_us) {
+    return t->nslowest < JS_TCPINFO_SLOWEST ||
+           latency_us > t->slowest[t->nslowest - 1].latency_us;
+}
+
+static void tcpinfo_insert_slow(js_tcpinfo_t *t, const js_tcpinfo_slow_t *s) {
+    int i = t->nslowest < JS_TCPINFO_SLOWEST ? t->nslowest++
+                                             : JS_TCPINFO_SLOWEST - 1;
+
+    /* Keep the list sorted, slowest first */
+    while (i > 0 && t->slowest[i - 1].latency_us < s->latency_us) {
+        t->slowest[i] = t->slowest[i - 1];
+        i--;
+    }
+    t->slowest[i] = *s;
+}
+
+void js_tcpinfo_add_slow(js_tcpinfo_t *t, const struct tcp_info *ti,
+                         double latency_us, int conn, int addr) {
+    js_tcpinfo_slow_t s = {
+        .latency_us = latency_us,
+        .conn = conn,
+        .addr = addr,
+        .rtt_us = ti->tcpi_rtt,
+        .rttvar_us = ti->tcpi_rttvar,
+        .rto_us = ti->tcpi_rto,
+        .retrans = ti->tcpi_total_retrans,
+        .cwnd = ti->tcpi_snd_cwnd,
+        .unacked = ti->tcpi_unacked,
+    };
+
+    if (js_tcpinfo_is_slow(t, latency_us)) tcpinfo_insert_slow(t, &s);
+}
+
+void js_tcpinfo_merge(js_tcpinfo_t *dst, const js_tcpinfo_t *src) {
+    dst->samples += src->samples;
+    dst->retrans += src->retrans;
+    js_hist_merge(&dst->rtt, &src->rtt);
+    js_hist_merge(&dst->rttvar, &src->rttvar);
+    js_hist_merge(&dst->cwnd, &src->cwnd);
+    js_hist_merge(&dst->unacked, &src->unacked);
+
+    for (int i = 0; i < src->nslowest; i++) {
+        if (js_tcpinfo_is_slow(dst, src->slowest[i].latency_us))
+            tcpinfo_insert_slow(dst, &src->slowest[i]);
+    }
+}
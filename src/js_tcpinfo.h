@@ -0,0 +1,47 @@
+#ifndef JS_TCPINFO_H
+#define JS_TCPINFO_H
+
+/* ── TCP_INFO sampling ────────────────────────────────────────────────── */
+
+/*
+ * What the kernel knows about the connections: round-trip time, its
+ * variance, congestion window and unacknowledged segments, sampled
+ * periodically into histograms, plus a snapshot taken as each of the
+ * slowest responses completed.
+ */
+
+#define JS_TCPINFO_SLOWEST    10
+#define JS_TCPINFO_BATCH      256     /* connections sampled per tick */
+
+typedef struct {
+    double      latency_us;
+    int         conn;            /* connection number, as ${conn} */
+    int         addr;            /* index into config->addrs */
+    uint32_t    rtt_us;
+    uint32_t    rttvar_us;
+    uint32_t    rto_us;
+    uint32_t    retrans;         /* retransmitted on this connection */
+    uint32_t    cwnd;
+    uint32_t    unacked;
+} js_tcpinfo_slow_t;
+
+typedef struct {
+    uint64_t           samples;
+    uint64_t           retrans;      /* segments retransmitted */
+    js_hist_t          rtt;          /* us */
+    js_hist_t          rttvar;       /* us */
+    js_hist_t          cwnd;         /* segments */
+    js_hist_t          unacked;      /* segments */
+    js_tcpinfo_slow_t  slowest[JS_TCPINFO_SLOWEST];   /* slowest first */
+    int                nslowest;
+} js_tcpinfo_t;
+
+void js_tcpinfo_init(js_tcpinfo_t *t);
+int  js_tcpinfo_get(int fd, struct tcp_info *ti);
+void js_tcpinfo_add(js_tcpinfo_t *t, const struct tcp_info *ti);
+bool js_tcpinfo_is_slow(const js_tcpinfo_t *t, double latency_us);
+void js_tcpinfo_add_slow(js_tcpinfo_t *t, const struct tcp_info *ti,
+                         double latency_us, int conn, int addr);
+void js_tcpinfo_merge(js_tcpinfo_t *dst, const js_tcpinfo_t *src);
+
+#endif /* JS_TCPINFO_H */
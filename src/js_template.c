@@ -0,0 +1,294 @@
+#include "js_main.h"
+
+/* ── Compile ──────────────────────────────────────────────────────────── */
+
+static int tpl_add_seg(js_template_t *t, const js_tpl_seg_t *seg) {
+    js_tpl_seg_t *segs = realloc(t->segs,
+                                 sizeof(js_tpl_seg_t) * (size_t)(t->nsegs + 1));
+    if (!segs) return -1;
+
+    t->segs = segs;
+    t->segs[t->nsegs++] = *seg;
+    return 0;
+}
+
+/* Add the literal [from, to), split at the start of the body */
+static int tpl_add_literal(js_template_t *t, const char *from, const char *to,
+                           const char *body) {
+    js_tpl_seg_t l = { .type = JS_TPL_LITERAL };
+
+    if (from < body && body < to) {
+        if (tpl_add_literal(t, from, body, body) != 0) return -1;
+        from = body;
+    }
+
+    if (to <= from) return 0;
+
+    l.data = from;
+    l.len = (size_t)(to - from);
+    l.in_body = from >= body;
+    return tpl_add_seg(t, &l);
+}
+
+/*
+ * Parse "${name}" at p.  Returns the number of bytes consumed, or 0 if
+ * the text is not a known variable (it is then kept as a literal).
+ */
+static size_t tpl_parse_var(const char *p, const char *end, js_tpl_seg_t *seg) {
+    if (end - p < 3 || p[0] != '$' || p[1] != '{') return 0;
+
+    const char *close = memchr(p + 2, '}', (size_t)(end - p - 2));
+    if (!close) return 0;
+
+    const char *name = p + 2;
+    size_t len = (size_t)(close - name);
+
+    memset(seg, 0, sizeof(*seg));
+
+    if (len == 7 && memcmp(name, "counter", 7) == 0) {
+        seg->type = JS_TPL_COUNTER;
+    } else if (len == 4 && memcmp(name, "uuid", 4) == 0) {
+        seg->type = JS_TPL_UUID;
+    } else if (len == 4 && memcmp(name, "conn", 4) == 0) {
+        seg->type = JS_TPL_CONN;
+    } else if (len == 4 && memcmp(name, "time", 4) == 0) {
+        seg->type = JS_TPL_TIME;
+    } else if (len > 7 && memcmp(name, "random(", 7) == 0 && close[-1] == ')') {
+        char args[64];
+        size_t alen = len - 8;
+        if (alen >= sizeof(args)) return 0;
+        memcpy(args, name + 7, alen);
+        args[alen] = '\0';
+
+        char *comma = strchr(args, ',');
+        if (!comma) return 0;
+        *comma = '\0';
+
+        char *e1, *e2;
+        double lo = strtod(args, &e1);
+        double hi = strtod(comma + 1, &e2);
+        if (e1 == args || e2 == comma + 1 || hi < lo) return 0;
+
+        seg->type = JS_TPL_RANDOM;
+        seg->min = (int64_t)lo;
+        seg->max = (int64_t)hi;
+    } else {
+        return 0;
+    }
+
+    return (size_t)(close - p) + 1;
+}
+
+static bool tpl_has_var(const char *p, const char *end) {
+    js_tpl_seg_t seg;
+
+    for (; p < end; p++) {
+        if (*p == '$' && tpl_parse_var(p, end, &seg) > 0)
+            return true;
+    }
+    return false;
+}
+
+int js_template_compile(js_template_t *t, const js_buf_t *raw) {
+    memset(t, 0, sizeof(*t));
+
+    const char *start = raw->data;
+    const char *end = raw->data + raw->len;
+
+    if (!tpl_has_var(start, end)) return 0;
+
+    /* Locate the body and, if it is dynamic, its Content-Length value */
+    const char *body = memmem(start, raw->len, "\r\n\r\n", 4);
+    body = body ? body + 4 : end;
+
+    const char *cl_start = NULL, *cl_end = NULL;
+
+    if (tpl_has_var(body, end)) {
+        const char *p = start;
+        const char *hit;
+        while ((hit = memmem(p, (size_t)(body - p), "\r\nContent-Length: ", 18))) {
+            cl_start = hit + 18;
+            p = cl_start;
+        }
+        if (cl_start) {
+            cl_end = cl_start;
+            while (cl_end < body && *cl_end >= '0' && *cl_end <= '9') cl_end++;
+        }
+    }
+
+    js_tpl_seg_t seg;
+    const char *lit = start;
+    const char *p = start;
+
+    while (p < end) {
+        size_t n = 0;
+        bool is_cl = (p == cl_start);
+
+        if (!is_cl && *p == '$')
+            n = tpl_parse_var(p, end, &seg);
+
+        if (!is_cl && n == 0) {
+            p++;
+            continue;
+        }
+
+        if (tpl_add_literal(t, lit, p, body) != 0) goto fail;
+
+        if (is_cl) {
+            memset(&seg, 0, sizeof(seg));
+            seg.type = JS_TPL_CONTENT_LENGTH;
+            p = cl_end;
+        } else {
+            if (t->nvars == JS_TPL_MAX_VARS) goto fail;
+            seg.in_body = p >= body;
+            t->nvars++;
+            p += n;
+        }
+
+        if (tpl_add_seg(t, &seg) != 0) goto fail;
+        lit = p;
+    }
+
+    if (tpl_add_literal(t, lit, end, body) != 0) goto fail;
+
+    t->max_len = raw->len + (size_t)(t->nvars + 1) * JS_TPL_VAR_MAX_LEN;
+    return 0;
+
+fail:
+    js_template_free(t);
+    return -1;
+}
+
+void js_template_free(js_template_t *t) {
+    free(t->segs);
+    memset(t, 0, sizeof(*t));
+}
+
+/* ── Render ───────────────────────────────────────────────────────────── */
+
+static uint64_t tpl_rand(js_tpl_vars_t *v) {
+    /* xorshift64* */
+    uint64_t x = v->rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    v->rng = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+void js_tpl_vars_init(js_tpl_vars_t *v, int worker_id, int nworkers) {
+    v->counter = (uint64_t)worker_id;
+    v->stride = nworkers > 0 ? (uint64_t)nworkers : 1;
+    v->rng = (js_now_ns() ^ ((uint64_t)(worker_id + 1) * 0x9E3779B97F4A7C15ULL))
+             | 1;
+}
+
+static size_t tpl_format_int(char *buf, int64_t val) {
+    char tmp[24];
+    size_t n = 0, len = 0;
+    uint64_t u = val < 0 ? (uint64_t)0 - (uint64_t)val : (uint64_t)val;
+
+    do {
+        tmp[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+
+    if (val < 0) buf[len++] = '-';
+    while (n) buf[len++] = tmp[--n];
+    return len;
+}
+
+static size_t tpl_format_uuid(char *buf, js_tpl_vars_t *v) {
+    static const char hex[] = "0123456789abcdef";
+    uint8_t b[16];
+    uint64_t r0 = tpl_rand(v), r1 = tpl_rand(v);
+
+    memcpy(b, &r0, 8);
+    memcpy(b + 8, &r1, 8);
+    b[6] = (uint8_t)((b[6] & 0x0f) | 0x40);   /* version 4 */
+    b[8] = (uint8_t)((b[8] & 0x3f) | 0x80);   /* RFC 4122 variant */
+
+    size_t len = 0;
+    for (int i = 0; i < 16; i++) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) buf[len++] = '-';
+        buf[len++] = hex[b[i] >> 4];
+        buf[len++] = hex[b[i] & 0x0f];
+    }
+    return len;
+}
+
+int js_template_render(const js_template_t *t, js_tpl_vars_t *v,
+                       int conn_id, js_buf_t *out) {
+    char vals[JS_TPL_MAX_VARS][JS_TPL_VAR_MAX_LEN];
+    size_t vlen[JS_TPL_MAX_VARS];
+    size_t body_len = 0;
+    int k = 0;
+
+    /* Every ${counter} in one request shares the same value */
+    uint64_t counter = v->counter;
+    v->counter += v->stride;
+
+    /* Pass 1: produce variable values and measure the body */
+    for (int i = 0; i < t->nsegs; i++) {
+        const js_tpl_seg_t *s = &t->segs[i];
+        char *buf = vals[k];
+
+        switch (s->type) {
+            case JS_TPL_LITERAL:
+                if (s->in_body) body_len += s->len;
+                continue;
+            case JS_TPL_CONTENT_LENGTH:
+                continue;
+            case JS_TPL_COUNTER:
+                vlen[k] = tpl_format_int(buf, (int64_t)counter);
+                break;
+            case JS_TPL_RANDOM: {
+                uint64_t span = (uint64_t)(s->max - s->min) + 1;
+                int64_t r = s->min + (int64_t)(span ? tpl_rand(v) % span
+                                                    : tpl_rand(v));
+                vlen[k] = tpl_format_int(buf, r);
+                break;
+            }
+            case JS_TPL_UUID:
+                vlen[k] = tpl_format_uuid(buf, v);
+                break;
+            case JS_TPL_CONN:
+                vlen[k] = tpl_format_int(buf, conn_id);
+                break;
+            case JS_TPL_TIME: {
+                js_realtime_t now;
+                js_realtime(&now);
+                vlen[k] = tpl_format_int(buf, now.sec * 1000 + now.nsec / 1000000);
+                break;
+            }
+        }
+
+        if (s->in_body) body_len += vlen[k];
+        k++;
+    }
+
+    /* Pass 2: assemble the request */
+    if (js_buf_ensure(out, t->max_len) < 0) return -1;
+
+    char *p = out->data;
+    k = 0;
+
+    for (int i = 0; i < t->nsegs; i++) {
+        const js_tpl_seg_t *s = &t->segs[i];
+
+        if (s->type == JS_TPL_LITERAL) {
+            memcpy(p, s->data, s->len);
+            p += s->len;
+        } else if (s->type == JS_TPL_CONTENT_LENGTH) {
+            p += tpl_format_int(p, (int64_t)body_len);
+        } else {
+            memcpy(p, vals[k], vlen[k]);
+            p += vlen[k];
+            k++;
+        }
+    }
+
+    out->len = (size_t)(p - out->data);
+    out->pos = 0;
+    return 0;
+}
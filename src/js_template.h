@@ -0,0 +1,57 @@
+#ifndef JS_TEMPLATE_H
+#define JS_TEMPLATE_H
+
+#define JS_TPL_MAX_VARS     32
+#define JS_TPL_VAR_MAX_LEN  40     /* widest rendered value (uuid = 36) */
+
+/* ── Request template ─────────────────────────────────────────────────── */
+
+/*
+ * A pre-serialized request split into literal slices and variable slots.
+ * Literal slices point into the original request buffer, so rendering is
+ * a sequence of memcpy() calls plus a few integer conversions.
+ */
+
+typedef enum {
+    JS_TPL_LITERAL,
+    JS_TPL_COUNTER,          /* ${counter}: unique per request */
+    JS_TPL_RANDOM,           /* ${random(min,max)} */
+    JS_TPL_UUID,             /* ${uuid}: random version 4 UUID */
+    JS_TPL_CONN,             /* ${conn}: connection number */
+    JS_TPL_TIME,             /* ${time}: unix time in milliseconds */
+    JS_TPL_CONTENT_LENGTH    /* body length, computed at render time */
+} js_tpl_type_t;
+
+typedef struct {
+    js_tpl_type_t  type;
+    const char    *data;     /* literal slice */
+    size_t         len;
+    int64_t        min;      /* random() bounds */
+    int64_t        max;
+    bool           in_body;
+} js_tpl_seg_t;
+
+typedef struct {
+    js_tpl_seg_t  *segs;
+    int            nsegs;
+    int            nvars;
+    size_t         max_len;  /* upper bound of a rendered request */
+} js_template_t;
+
+/* ── Per-worker variable state ────────────────────────────────────────── */
+
+typedef struct {
+    uint64_t  counter;
+    uint64_t  stride;        /* number of workers, keeps counters disjoint */
+    uint64_t  rng;
+} js_tpl_vars_t;
+
+int   js_template_compile(js_template_t *t, const js_buf_t *raw);
+void  js_template_free(js_template_t *t);
+void  js_tpl_vars_init(js_tpl_vars_t *v, int worker_id, int nworkers);
+int   js_template_render(const js_template_t *t, js_tpl_vars_t *v,
+                         int conn_id, js_buf_t *out);
+
+#define js_template_is_dynamic(t)  ((t)->nvars > 0)
+
+#endif /* JS_TEMPLATE_H */
@@ -1,8 +1,27 @@
 #ifndef JS_THREAD_H
 #define JS_THREAD_H
 
+/*
+ * Hot-path counters, kept per thread so counting is a plain increment.
+ * Wire bytes are what went through the socket (or TLS), headers and
+ * dropped bodies included.
+ */
 typedef struct {
-    js_engine_t  *engine;
+    uint64_t      reads;          /* read(), recv(), SSL_read() */
+    uint64_t      read_bytes;
+    uint64_t      writes;         /* write(), sendfile(), SSL_write() */
+    uint64_t      write_bytes;
+    uint64_t      epoll_waits;
+    uint64_t      epoll_events;
+    uint64_t      epoll_ctls;
+    uint64_t      parses;         /* js_http_response_feed() calls */
+    uint64_t      responses;      /* responses parsed to the end */
+    uint64_t      buf_grows;      /* js_buf_ensure() reallocations */
+} js_counters_t;
+
+typedef struct {
+    js_engine_t   *engine;
+    js_counters_t  counters;
 } js_thread_t;
 
 extern __thread js_thread_t  js_thread_ctx;
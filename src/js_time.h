@@ -2,8 +2,7 @@
 #define JS_TIME_H
 
 typedef int64_t js_time_t;
-typedef uint32_t js_msec_t;
-typedef int32_t js_msec_int_t;
+typedef uint64_t js_usec_t;
 typedef uint64_t js_nsec_t;
 
 typedef struct {
@@ -1,127 +1,179 @@
 #include "js_main.h"
 
-static intptr_t js_timer_rbtree_compare(js_rbtree_node_t *node1,
-    js_rbtree_node_t *node2)
-{
-    js_timer_t *timer1, *timer2;
-
-    timer1 = (js_timer_t *) node1;
-    timer2 = (js_timer_t *) node2;
+/* idx of a timer on the expired list */
+#define JS_TIMER_EXPIRED  (JS_TIMER_LEVELS * JS_TIMER_LVL_SIZE)
 
-    /*
-     * Timer values are distributed in small range, usually several minutes
-     * and overflow every 49 days if js_msec_t is stored in 32 bits.
-     * This signed comparison takes into account that overflow.
-     */
-    return (js_msec_int_t) (timer1->time - timer2->time);
+static inline js_usec_t js_timer_digit(js_usec_t time, int level)
+{
+    return (time >> (level * JS_TIMER_LVL_BITS)) & JS_TIMER_LVL_MASK;
 }
 
-void js_timers_init(js_timers_t *timers)
+static inline js_usec_t js_timer_above(js_usec_t time, int level)
 {
-    js_rbtree_init(&timers->tree, js_timer_rbtree_compare);
-    timers->now = 0;
-    timers->minimum = 0;
+    int shift;
+
+    shift = (level + 1) * JS_TIMER_LVL_BITS;
+
+    return shift < 64 ? time >> shift : 0;
 }
 
-void js_timer_add(js_timers_t *timers, js_timer_t *timer, js_msec_t timeout)
+/*
+ * The expiry is strictly ahead of the wheel position.  Its level is that
+ * of the highest differing digit, so within the level the slot is always
+ * ahead of the position's own digit and slots never wrap around.
+ */
+static void js_timer_insert(js_timers_t *timers, js_timer_t *timer)
 {
-    int32_t diff;
-    js_msec_t time;
+    int level, slot;
 
-    time = timers->now + timeout;
+    if (timer->time <= timers->curtime) {
+        timer->idx = JS_TIMER_EXPIRED;
+        list_add_tail(&timer->link, &timers->expired);
+        return;
+    }
 
-    timer->enabled = 1;
+    level = (63 - __builtin_clzll(timer->time ^ timers->curtime))
+            / JS_TIMER_LVL_BITS;
+    slot = (int) js_timer_digit(timer->time, level);
 
-    if (js_timer_is_in_tree(timer)) {
-        diff = (js_msec_int_t) (time - timer->time);
+    timer->idx = (uint16_t) (level * JS_TIMER_LVL_SIZE + slot);
+    list_add_tail(&timer->link, &timers->slots[level][slot]);
+    timers->pending[level] |= (uint64_t) 1 << slot;
+}
 
-        if (diff >= -(int32_t)timer->bias && diff <= (int32_t)timer->bias) {
-            return;
-        }
+void js_timers_init(js_timers_t *timers, js_usec_t now)
+{
+    int level, slot;
 
-        js_rbtree_delete(&timers->tree, &timer->node);
-        js_timer_in_tree_clear(timer);
+    for (level = 0; level < JS_TIMER_LEVELS; level++) {
+        for (slot = 0; slot < JS_TIMER_LVL_SIZE; slot++) {
+            init_list_head(&timers->slots[level][slot]);
+        }
+        timers->pending[level] = 0;
     }
 
-    timer->time = time;
-    js_rbtree_insert(&timers->tree, &timer->node);
+    init_list_head(&timers->expired);
+    timers->now = now;
+    timers->curtime = now;
 }
 
-void js_timer_delete(js_timers_t *timers, js_timer_t *timer)
+void js_timer_add(js_timers_t *timers, js_timer_t *timer, js_usec_t timeout)
 {
-    timer->enabled = 0;
+    js_timer_delete(timers, timer);
 
-    if (js_timer_is_in_tree(timer)) {
-        js_rbtree_delete(&timers->tree, &timer->node);
-        js_timer_in_tree_clear(timer);
-    }
+    timer->time = timers->now + timeout;
+    js_timer_insert(timers, timer);
 }
 
-js_msec_t js_timer_find(js_timers_t *timers)
+void js_timer_delete(js_timers_t *timers, js_timer_t *timer)
 {
-    int32_t delta;
-    js_msec_t time;
-    js_timer_t *timer;
-    js_rbtree_t *tree;
-    js_rbtree_node_t *node, *next;
+    int idx;
 
-    tree = &timers->tree;
+    if (!js_timer_is_pending(timer)) {
+        return;
+    }
 
-    for (node = js_rbtree_min(tree);
-         js_rbtree_is_there_successor(tree, node);
-         node = next)
-    {
-        next = js_rbtree_node_successor(tree, node);
+    list_del(&timer->link);
+
+    idx = timer->idx;
 
-        timer = (js_timer_t *) node;
+    if (idx != JS_TIMER_EXPIRED
+        && list_empty(&timers->slots[0][0] + idx))
+    {
+        timers->pending[idx / JS_TIMER_LVL_SIZE] &=
+            ~((uint64_t) 1 << (idx % JS_TIMER_LVL_SIZE));
+    }
+}
 
-        if (timer->enabled) {
-            time = timer->time;
-            timers->minimum = time - timer->bias;
+/*
+ * Time until the start of the first pending slot.  Every slot of a level
+ * lies inside the current slot of the level above, so the lowest
+ * non-empty level holds the earliest one.  Above level 0 the wakeup only
+ * cascades the slot, which is cheap and rare.
+ */
+js_usec_t js_timer_find(js_timers_t *timers)
+{
+    int level, shift;
+    js_usec_t start;
 
-            delta = (js_msec_int_t) (time - timers->now);
+    if (!list_empty(&timers->expired)) {
+        return 0;
+    }
 
-            return (js_msec_t) (delta > 0 ? delta : 0);
+    for (level = 0; level < JS_TIMER_LEVELS; level++) {
+        if (timers->pending[level] == 0) {
+            continue;
         }
-    }
 
-    timers->minimum = timers->now + 24 * 60 * 60 * 1000;
+        shift = level * JS_TIMER_LVL_BITS;
+
+        start = js_timer_above(timers->curtime, level);
+        start = shift + JS_TIMER_LVL_BITS < 64
+                ? start << (shift + JS_TIMER_LVL_BITS) : 0;
+        start |= (js_usec_t) __builtin_ctzll(timers->pending[level]) << shift;
 
-    return (js_msec_t) -1;
+        return start > timers->now ? start - timers->now : 0;
+    }
+
+    return (js_usec_t) -1;
 }
 
-void js_timer_expire(js_timers_t *timers, js_msec_t now)
+void js_timer_expire(js_timers_t *timers, js_usec_t now)
 {
+    int level, slot;
+    uint64_t mask;
     js_timer_t *timer;
-    js_rbtree_t *tree;
-    js_rbtree_node_t *node, *next;
+    struct list_head todo, *el, *next;
 
     timers->now = now;
+    init_list_head(&todo);
 
-    if ((js_msec_int_t) (timers->minimum - now) > 0) {
-        return;
-    }
+    if (now > timers->curtime) {
 
-    tree = &timers->tree;
+        /* Collect the slots the position moves past or into */
+        for (level = 0; level < JS_TIMER_LEVELS; level++) {
+            mask = timers->pending[level];
 
-    for (node = js_rbtree_min(tree);
-         js_rbtree_is_there_successor(tree, node);
-         node = next)
-    {
-        timer = (js_timer_t *) node;
+            if (mask == 0) {
+                continue;
+            }
 
-        if ((js_msec_int_t) (timer->time - now) > (int32_t) timer->bias) {
-            return;
-        }
+            if (js_timer_above(now, level)
+                == js_timer_above(timers->curtime, level))
+            {
+                mask &= ((uint64_t) 2 << js_timer_digit(now, level)) - 1;
+            }
+
+            timers->pending[level] &= ~mask;
+
+            while (mask != 0) {
+                slot = __builtin_ctzll(mask);
+                mask &= mask - 1;
 
-        next = js_rbtree_node_successor(tree, node);
+                list_for_each_safe(el, next, &timers->slots[level][slot]) {
+                    list_del(el);
+                    list_add_tail(el, &todo);
+                }
+            }
+        }
 
-        js_rbtree_delete(tree, &timer->node);
-        js_timer_in_tree_clear(timer);
+        timers->curtime = now;
 
-        if (timer->enabled) {
-            timer->enabled = 0;
-            timer->handler(timer, timer->data);
+        list_for_each_safe(el, next, &todo) {
+            list_del(el);
+            js_timer_insert(timers, list_entry(el, js_timer_t, link));
         }
     }
+
+    /* Handlers may add or delete timers, due ones wait for the next call */
+    list_for_each_safe(el, next, &timers->expired) {
+        list_del(el);
+        list_add_tail(el, &todo);
+    }
+
+    while (!list_empty(&todo)) {
+        timer = list_entry(todo.next, js_timer_t, link);
+        list_del(&timer->link);
+        timer->handler(timer, timer->data);
+    }
 }
@@ -1,46 +1,50 @@
 #ifndef JS_TIMER_H
 #define JS_TIMER_H
 
-#define JS_TIMER_DEFAULT_BIAS  50
+/*
+ * Hierarchical timing wheel with microsecond ticks.  Level n has 64
+ * slots of 64^n us each, eleven levels cover the whole 64-bit range.  A
+ * timer sits at the level of the highest 6-bit digit where its expiry
+ * differs from the wheel position, in the slot of that digit, and
+ * cascades down as the position reaches its slot.  Adding and deleting a
+ * timer are O(1), finding the next expiry is O(levels).
+ */
+
+#define JS_TIMER_LVL_BITS  6
+#define JS_TIMER_LVL_SIZE  (1 << JS_TIMER_LVL_BITS)
+#define JS_TIMER_LVL_MASK  (JS_TIMER_LVL_SIZE - 1)
+#define JS_TIMER_LEVELS    11
 
 typedef struct js_timer_s js_timer_t;
 
 typedef void (*js_timer_handler_t)(js_timer_t *timer, void *data);
 
 struct js_timer_s {
-    /* The rbtree node must be the first field. */
-    js_rbtree_node_t node;
-    uint8_t bias;
-    uint8_t enabled;
-    js_msec_t time;
+    struct list_head link;      /* next == NULL while not pending */
+    js_usec_t time;
+    uint16_t idx;               /* level * 64 + slot */
     js_timer_handler_t handler;
     void *data;
 };
 
 typedef struct {
-    js_rbtree_t tree;
-    js_msec_t now;
-    js_msec_t minimum;
+    struct list_head slots[JS_TIMER_LEVELS][JS_TIMER_LVL_SIZE];
+    uint64_t pending[JS_TIMER_LEVELS];      /* non-empty slots */
+    struct list_head expired;               /* due before they were added */
+    js_usec_t now;                          /* set by the caller */
+    js_usec_t curtime;                      /* wheel position */
 } js_timers_t;
 
 #define js_timer_data(obj, type, timer) \
     js_container_of(obj, type, timer)
 
-#define js_timer_is_in_tree(timer) \
-    ((timer)->node.parent != NULL)
+#define js_timer_is_pending(timer) \
+    ((timer)->link.next != NULL)
 
-#define js_timer_in_tree_clear(timer) \
-    (timer)->node.parent = NULL
-
-void js_timers_init(js_timers_t *timers);
-js_msec_t js_timer_find(js_timers_t *timers);
-void js_timer_expire(js_timers_t *timers, js_msec_t now);
-void js_timer_add(js_timers_t *timers, js_timer_t *timer, js_msec_t timeout);
+void js_timers_init(js_timers_t *timers, js_usec_t now);
+js_usec_t js_timer_find(js_timers_t *timers);
+void js_timer_expire(js_timers_t *timers, js_usec_t now);
+void js_timer_add(js_timers_t *timers, js_timer_t *timer, js_usec_t timeout);
 void js_timer_delete(js_timers_t *timers, js_timer_t *timer);
 
-static inline void js_timer_disable(js_timer_t *timer)
-{
-    timer->enabled = 0;
-}
-
 #endif /* JS_TIMER_H */
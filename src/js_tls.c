@@ -1,17 +1,71 @@
 #include "js_main.h"
 
-SSL_CTX *js_tls_ctx_create(void) {
+/* "http/1.1,h2" to ALPN wire format: length-prefixed names */
+static int tls_set_alpn(SSL_CTX *ctx, const char *list) {
+    unsigned char wire[sizeof(((js_tlsopts_t *)0)->alpn) + 1];
+    size_t len = 0;
+
+    while (*list) {
+        size_t n = strcspn(list, ",");
+        if (n == 0 || n > 255 || len + 1 + n > sizeof(wire)) return -1;
+
+        wire[len++] = (unsigned char)n;
+        memcpy(wire + len, list, n);
+        len += n;
+
+        list += n;
+        if (*list == ',') list++;
+    }
+
+    /* Returns 0 on success, unlike most of OpenSSL */
+    return SSL_CTX_set_alpn_protos(ctx, wire, (unsigned)len) == 0 ? 0 : -1;
+}
+
+static int tls_apply(SSL_CTX *ctx, const js_tlsopts_t *opts) {
+#ifdef SSL_OP_ENABLE_KTLS
+    /* Hand record encryption to the kernel, if it and the cipher allow */
+    if (opts->ktls)
+        SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+#endif
+
+    if (opts->version &&
+        (!SSL_CTX_set_min_proto_version(ctx, opts->version) ||
+         !SSL_CTX_set_max_proto_version(ctx, opts->version)))
+        return -1;
+
+    if (opts->ciphers[0] && !SSL_CTX_set_cipher_list(ctx, opts->ciphers))
+        return -1;
+
+    if (opts->ciphersuites[0] &&
+        !SSL_CTX_set_ciphersuites(ctx, opts->ciphersuites))
+        return -1;
+
+    if (opts->alpn[0] && tls_set_alpn(ctx, opts->alpn) != 0)
+        return -1;
+
+    return 0;
+}
+
+SSL_CTX *js_tls_ctx_create(const js_tlsopts_t *opts) {
     SSL_CTX *ctx = SSL_CTX_new(TLS_client_method());
     if (!ctx) return NULL;
 
     SSL_CTX_set_default_verify_paths(ctx);
     SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, NULL);
+
+    /* Idle connections give their record buffers back */
     SSL_CTX_set_mode(ctx, SSL_MODE_ENABLE_PARTIAL_WRITE |
-                          SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+                          SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER |
+                          SSL_MODE_RELEASE_BUFFERS);
 
     /* Disable compression */
     SSL_CTX_set_options(ctx, SSL_OP_NO_COMPRESSION);
 
+    if (opts && tls_apply(ctx, opts) != 0) {
+        SSL_CTX_free(ctx);
+        return NULL;
+    }
+
     return ctx;
 }
 
@@ -69,6 +123,38 @@ ssize_t js_tls_write(SSL *ssl, const void *buf, size_t len) {
     return -1;
 }
 
+/* Whether this OpenSSL can hand records to the kernel at all */
+bool js_tls_ktls_available(void) {
+#ifdef SSL_OP_ENABLE_KTLS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/* Whether the kernel took over sending and receiving records */
+void js_tls_ktls(SSL *ssl, bool *tx, bool *rx) {
+#ifdef SSL_OP_ENABLE_KTLS
+    *tx = BIO_get_ktls_send(SSL_get_wbio(ssl));
+    *rx = BIO_get_ktls_recv(SSL_get_rbio(ssl));
+#else
+    (void) ssl;
+    *tx = false;
+    *rx = false;
+#endif
+}
+
+/* The connection's session if it can be resumed, or NULL; caller frees */
+SSL_SESSION *js_tls_session(SSL *ssl) {
+    SSL_SESSION *sess = SSL_get1_session(ssl);
+
+    if (sess && !SSL_SESSION_is_resumable(sess)) {
+        SSL_SESSION_free(sess);
+        return NULL;
+    }
+    return sess;
+}
+
 void js_tls_free(SSL *ssl) {
     if (ssl) {
         SSL_shutdown(ssl);
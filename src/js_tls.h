@@ -1,11 +1,24 @@
 #ifndef JS_TLS_H
 #define JS_TLS_H
 
-SSL_CTX *js_tls_ctx_create(void);
+/* bench.tls */
+typedef struct {
+    bool     ktls;           /* SSL_OP_ENABLE_KTLS */
+    bool     resume;         /* resume sessions on reconnect */
+    int      version;        /* pin TLS1_2_VERSION or TLS1_3_VERSION, 0: any */
+    char     ciphers[256];   /* TLS 1.2 cipher list, "": default */
+    char     ciphersuites[256];  /* TLS 1.3 suites, "": default */
+    char     alpn[64];       /* "http/1.1,h2", "": none offered */
+} js_tlsopts_t;
+
+SSL_CTX *js_tls_ctx_create(const js_tlsopts_t *opts);
 SSL     *js_tls_new(SSL_CTX *ctx, int fd, const char *hostname);
 int      js_tls_handshake(SSL *ssl);
 ssize_t  js_tls_read(SSL *ssl, void *buf, size_t len);
 ssize_t  js_tls_write(SSL *ssl, const void *buf, size_t len);
+bool     js_tls_ktls_available(void);
+void     js_tls_ktls(SSL *ssl, bool *tx, bool *rx);
+SSL_SESSION *js_tls_session(SSL *ssl);
 void     js_tls_free(SSL *ssl);
 
 #endif /* JS_TLS_H */
@@ -7,6 +7,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <limits.h>
 #include <stdatomic.h>
 #include <errno.h>
 #include <unistd.h>
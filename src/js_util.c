@@ -20,6 +20,25 @@ double js_parse_duration(const char *s) {
     }
 }
 
+/* "4096", "64KB", "4MB", "1GB" (powers of 1024) */
+uint64_t js_parse_size(const char *s) {
+    if (!s || !*s) return 0;
+    char *end;
+    double val = strtod(s, &end);
+    if (end == s || val < 0) return 0;
+
+    switch (*end) {
+        case 'k': case 'K':
+            return (uint64_t)(val * 1024);
+        case 'm': case 'M':
+            return (uint64_t)(val * 1024 * 1024);
+        case 'g': case 'G':
+            return (uint64_t)(val * 1024 * 1024 * 1024);
+        default:
+            return (uint64_t)val;
+    }
+}
+
 char *js_read_file(const char *path, size_t *len) {
     FILE *f = fopen(path, "rb");
     if (!f) return NULL;
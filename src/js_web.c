@@ -127,6 +127,44 @@ int js_request_serialize(js_request_t *req, const char *host_override,
     return 0;
 }
 
+/*
+ * Make a serialized request the last one on its connection: its
+ * Connection header is replaced by "Connection: close", or one is added.
+ */
+int js_request_set_close(js_buf_t *out) {
+    static const char close_hdr[] = "Connection: close\r\n";
+    const size_t close_len = sizeof(close_hdr) - 1;
+
+    char *hdr_end = memmem(out->data, out->len, "\r\n\r\n", 4);
+    if (hdr_end == NULL) return -1;
+
+    /* Header lines start after the request line */
+    char *line = memmem(out->data, out->len, "\r\n", 2) + 2;
+    char *eol = hdr_end + 2;
+
+    while (line < hdr_end + 2) {
+        char *next = memmem(line, (size_t)(hdr_end + 2 - line), "\r\n", 2) + 2;
+        if (next - line > 11 && strncasecmp(line, "Connection:", 11) == 0) {
+            eol = next;
+            break;
+        }
+        line = next;
+    }
+
+    /* Replace [line, eol): the old header, or nothing before the blank line */
+    size_t off = (size_t)(line - out->data);
+    size_t old = (size_t)(eol - line);
+    size_t len = out->len - old + close_len;
+
+    if (js_buf_ensure(out, len) < 0) return -1;
+
+    memmove(out->data + off + close_len, out->data + off + old,
+            out->len - off - old);
+    memcpy(out->data + off, close_hdr, close_len);
+    out->len = len;
+    return 0;
+}
+
 void js_request_free(js_request_t *req) {
     free(req->method);
     free(req->headers);
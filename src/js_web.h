@@ -27,10 +27,12 @@ typedef struct {
 int     js_parse_url(const char *url_str, js_url_t *out);
 int     js_request_serialize(js_request_t *req, const char *host_override,
                               js_buf_t *out);
+int     js_request_set_close(js_buf_t *out);
 void    js_request_free(js_request_t *req);
 
 void    js_headers_init(JSContext *ctx);
-JSValue js_headers_from_http(JSContext *ctx, const js_http_response_t *parsed);
+int     js_headers_pack(const js_http_response_t *parsed, js_buf_t *out);
+JSValue js_headers_from_packed(JSContext *ctx, const char *data, int count);
 
 void    js_response_init(JSContext *ctx);
 JSValue js_response_new(JSContext *ctx, int status, const char *status_text,
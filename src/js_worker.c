@@ -1,4 +1,5 @@
 #include "js_main.h"
+#include <sys/resource.h>
 
 /* ── Duration timer handler ──────────────────────────────────────────── */
 
@@ -7,6 +8,144 @@ static void worker_duration_handler(js_timer_t *timer, void *data) {
     atomic_store(stop, true);
 }
 
+/* ── Self-overhead ────────────────────────────────────────────────────── */
+
+static void worker_thread_cpu(double *user, double *sys) {
+    struct rusage ru;
+
+    getrusage(RUSAGE_THREAD, &ru);
+    *user = (double)ru.ru_utime.tv_sec + (double)ru.ru_utime.tv_usec / 1e6;
+    *sys = (double)ru.ru_stime.tv_sec + (double)ru.ru_stime.tv_usec / 1e6;
+}
+
+/* Turn a snapshot of the thread's counters into the counts since */
+static void worker_counters_since(js_counters_t *k, const js_counters_t *now) {
+    k->reads = now->reads - k->reads;
+    k->read_bytes = now->read_bytes - k->read_bytes;
+    k->writes = now->writes - k->writes;
+    k->write_bytes = now->write_bytes - k->write_bytes;
+    k->epoll_waits = now->epoll_waits - k->epoll_waits;
+    k->epoll_events = now->epoll_events - k->epoll_events;
+    k->epoll_ctls = now->epoll_ctls - k->epoll_ctls;
+    k->parses = now->parses - k->parses;
+    k->responses = now->responses - k->responses;
+    k->buf_grows = now->buf_grows - k->buf_grows;
+}
+
+/* Start (or restart, after warmup) measuring the worker's own cost */
+static void worker_self_start(js_worker_t *w) {
+    worker_thread_cpu(&w->cpu_user, &w->cpu_sys);
+    w->cpu_ns = js_now_ns();
+    w->wakeups = 0;
+    w->events = 0;
+    if (w->loop_lag) js_hist_init(w->loop_lag);
+    w->counters = js_thread()->counters;
+    if (w->config->perf) js_perf_start(&w->perf);
+}
+
+static void worker_self_stop(js_worker_t *w) {
+    double user, sys;
+
+    worker_thread_cpu(&user, &sys);
+    w->cpu_user = user - w->cpu_user;
+    w->cpu_sys = sys - w->cpu_sys;
+    w->cpu_ns = js_now_ns() - w->cpu_ns;
+    worker_counters_since(&w->counters, &js_thread()->counters);
+    if (w->config->perf) js_perf_stop(&w->perf);
+}
+
+/*
+ * One turn of the event loop: wait, dispatch, expire timers.  The time
+ * from the wakeup to the end of the turn is the loop lag, the least
+ * delay an event that became ready meanwhile will see.
+ */
+static int worker_loop_once(js_worker_t *w, int64_t timeout_us) {
+    js_engine_t *engine = js_thread()->engine;
+
+    int n = js_epoll_poll(engine, timeout_us);
+    if (n < 0) return -1;
+
+    js_timer_expire(&engine->timers, js_now_ns() / 1000);
+
+    if (n > 0) {
+        w->wakeups++;
+        w->events += (uint64_t) n;
+        if (w->loop_lag) {
+            js_hist_add(w->loop_lag,
+                        (double)(js_now_ns() - engine->wakeup_ns) / 1000.0);
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * End of warmup: drop everything recorded so far.  Stats are only touched
+ * by their own worker, so this needs no locking.
+ */
+static void worker_warmup_handler(js_timer_t *timer, void *data) {
+    js_worker_t *w = data;
+    js_stats_init(&w->stats);
+    if (w->addr_stats) {
+        for (int i = 0; i < w->config->naddrs; i++)
+            js_addr_stats_init(&w->addr_stats[i]);
+    }
+    if (w->kernel_latency) js_hist_init(w->kernel_latency);
+    w->fastopen_conns = 0;
+    w->fastopen = 0;
+    if (w->tcpinfo) js_tcpinfo_init(w->tcpinfo);
+    worker_self_start(w);
+    w->measure_ns = js_now_ns();
+}
+
+/* Preconnect: wait for every worker to be set up, then start the clock */
+static void worker_barrier(js_worker_t *w) {
+    if (w->barrier == NULL) return;
+
+    pthread_barrier_wait(w->barrier);
+    w->barrier = NULL;
+    w->start_ns = js_now_ns();
+}
+
+/*
+ * How long the event loop may sleep, in microseconds: until the next
+ * timer, at most cap.  With bench.busyPoll it never sleeps, so a response
+ * is picked up without waiting for the scheduler to wake the thread.
+ */
+static int64_t worker_poll_timeout(js_worker_t *w, int64_t cap) {
+    if (w->config->busy_poll) return 0;
+
+    js_usec_t timer_timeout = js_timer_find(&js_thread()->engine->timers);
+
+    if (timer_timeout == (js_usec_t) -1 || timer_timeout > (js_usec_t) cap)
+        return cap;
+    return (int64_t) timer_timeout;
+}
+
+/* Arm the warmup and duration timers; the duration follows the warmup */
+static void worker_timers_start(js_worker_t *w, js_timer_t *warmup,
+                                js_timer_t *duration) {
+    js_config_t *cfg = w->config;
+    js_engine_t *engine = js_thread()->engine;
+
+    w->measure_ns = w->start_ns;
+    engine->timers.now = js_now_ns() / 1000;
+
+    if (cfg->warmup_sec > 0) {
+        warmup->handler = worker_warmup_handler;
+        warmup->data = w;
+        js_timer_add(&engine->timers, warmup,
+                     (js_usec_t)(cfg->warmup_sec * 1e6));
+    }
+
+    if (cfg->duration_sec > 0) {
+        duration->handler = worker_duration_handler;
+        duration->data = &w->stop;
+        js_timer_add(&engine->timers, duration,
+                     (js_usec_t)((cfg->warmup_sec + cfg->duration_sec) * 1e6));
+    }
+}
+
 /* ── C-path connection handlers ──────────────────────────────────────── */
 
 static bool worker_keepalive(js_http_response_t *r) {
@@ -16,169 +155,841 @@ static bool worker_keepalive(js_http_response_t *r) {
     return true;
 }
 
+/*
+ * Keep the connection for another request: the server allows it and
+ * bench.maxRequests has not been reached.
+ */
+static bool worker_conn_keep(js_worker_t *w, js_conn_t *c,
+                             js_http_response_t *r) {
+    int max = w->config->max_requests;
+
+    c->requests++;
+    if (max > 0 && c->requests >= max) return false;
+    return worker_keepalive(r);
+}
+
+/* ── Target addresses ─────────────────────────────────────────────────── */
+
+/* Address for connection id; it keeps it across reconnects */
+static int worker_pick_addr(js_worker_t *w, int id) {
+    js_config_t *cfg = w->config;
+
+    switch (cfg->addr_policy) {
+        case JS_ADDR_ROUNDROBIN:
+            return id % cfg->naddrs;
+        case JS_ADDR_RANDOM:
+            return (int) ((unsigned) rand_r(&w->addr_seed) %
+                          (unsigned) cfg->naddrs);
+        default:
+            return 0;
+    }
+}
+
+/* Options applied to every socket a worker opens */
+static void worker_socket_options(js_worker_t *w, js_conn_t *c) {
+    js_config_t *cfg = w->config;
+
+    if (c->socket.fd < 0) return;
+
+    /* Only the body length is counted: drop bodies in the kernel */
+    c->discard = (c->ssl == NULL);
+
+    if (cfg->timestamps != JS_TSTAMP_NONE && c->ssl == NULL)
+        js_conn_timestamping(c);
+
+    if (cfg->busy_poll_us > 0) {
+        int usec = cfg->busy_poll_us;
+        setsockopt(c->socket.fd, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec));
+#ifdef SO_PREFER_BUSY_POLL
+        int one = 1;
+        setsockopt(c->socket.fd, SOL_SOCKET, SO_PREFER_BUSY_POLL,
+                   &one, sizeof(one));
+#endif
+    }
+}
+
+static js_conn_t *worker_conn_create(js_worker_t *w, int addr) {
+    js_config_t *cfg = w->config;
+    js_addr_t *a = &cfg->addrs[addr];
+
+    js_conn_t *c = js_conn_create((struct sockaddr *)&a->sa, a->len,
+                                  w->ssl_ctx, cfg->url.host, &cfg->sockopts);
+    if (c) {
+        c->addr = addr;
+        worker_socket_options(w, c);
+    }
+    return c;
+}
+
+static void worker_conn_reconnect(js_worker_t *w, js_conn_t *c) {
+    js_config_t *cfg = w->config;
+    js_addr_t *a = &cfg->addrs[c->addr];
+
+    /* Abortive close: no TIME_WAIT left behind by connection churn */
+    if (cfg->reset_on_close && c->socket.fd >= 0) {
+        struct linger lg = { .l_onoff = 1, .l_linger = 0 };
+        setsockopt(c->socket.fd, SOL_SOCKET, SO_LINGER, &lg, sizeof(lg));
+    }
+
+    /* Keep the session (or the ticket it came with) to resume */
+    if (c->ssl && w->sessions) {
+        SSL_SESSION *sess = js_tls_session(c->ssl);
+        if (sess) {
+            if (w->sessions[c->addr]) SSL_SESSION_free(w->sessions[c->addr]);
+            w->sessions[c->addr] = sess;
+        }
+    }
+
+    js_conn_reset(c, (struct sockaddr *)&a->sa, a->len,
+                  w->ssl_ctx, cfg->url.host, &cfg->sockopts);
+    worker_socket_options(w, c);
+
+    if (c->ssl && w->sessions && w->sessions[c->addr])
+        SSL_set_session(c->ssl, w->sessions[c->addr]);
+}
+
+/*
+ * A TLS context per worker: its session state and locks are not shared
+ * with the other threads
+ */
+static int worker_tls_init(js_worker_t *w) {
+    js_config_t *cfg = w->config;
+
+    w->ssl_ctx = NULL;
+    w->sessions = NULL;
+
+    if (!cfg->use_tls || cfg->mode == MODE_BENCH_ASYNC) return 0;
+
+    w->ssl_ctx = js_tls_ctx_create(&cfg->tls);
+    if (w->ssl_ctx == NULL) return -1;
+
+    if (cfg->tls.resume) {
+        w->sessions = calloc((size_t)cfg->naddrs, sizeof(SSL_SESSION *));
+        if (w->sessions == NULL) return -1;
+    }
+
+    return 0;
+}
+
+static void worker_tls_free(js_worker_t *w) {
+    if (w->sessions) {
+        for (int i = 0; i < w->config->naddrs; i++) {
+            if (w->sessions[i]) SSL_SESSION_free(w->sessions[i]);
+        }
+        free(w->sessions);
+        w->sessions = NULL;
+    }
+
+    if (w->ssl_ctx) {
+        SSL_CTX_free(w->ssl_ctx);
+        w->ssl_ctx = NULL;
+    }
+}
+
+/* ── Stats ────────────────────────────────────────────────────────────── */
+
+static void worker_stats_response(js_stats_t *s, js_http_response_t *r,
+                                  double elapsed_us) {
+    s->requests++;
+    s->bytes_read += r->body_len + r->body_skipped;
+    js_hist_add(&s->latency, elapsed_us);
+
+    int code = r->status_code;
+    if (code >= 200 && code < 300) s->status_2xx++;
+    else if (code >= 300 && code < 400) s->status_3xx++;
+    else if (code >= 400 && code < 500) s->status_4xx++;
+    else if (code >= 500) s->status_5xx++;
+}
+
+/*
+ * Count a response in the totals and in its address's stats.  With
+ * kernel timestamps, the time from the request leaving the stack to the
+ * response arriving goes into a histogram of its own, leaving out time
+ * the worker was busy elsewhere; the latency is always timed as usual.
+ */
+static void worker_count_response(js_worker_t *w, js_conn_t *c,
+                                  js_http_response_t *r, uint64_t start_ns) {
+    double elapsed_us = (double)(js_now_ns() - start_ns) / 1000.0;
+
+    if (c->timestamping && w->kernel_latency) {
+        js_conn_read_errqueue(c);
+
+        if (c->tx_ts_ns && c->rx_ts_ns > c->tx_ts_ns) {
+            js_hist_add(w->kernel_latency,
+                        (double)(c->rx_ts_ns - c->tx_ts_ns) / 1000.0);
+        }
+    }
+
+    worker_stats_response(&w->stats, r, elapsed_us);
+    if (w->addr_stats) {
+        js_addr_stats_t *as = &w->addr_stats[c->addr];
+        as->requests++;
+        js_hist_add(&as->latency, elapsed_us);
+    }
+
+    /* First response on a fast open connection: did the SYN carry data? */
+    if (w->config->sockopts.fast_open && c->requests == 0) {
+        struct tcp_info ti;
+        w->fastopen_conns++;
+        if (js_tcpinfo_get(c->socket.fd, &ti) == 0 &&
+            (ti.tcpi_options & TCPI_OPT_SYN_DATA))
+            w->fastopen++;
+    }
+
+    /* One of the slowest so far: note what TCP looked like */
+    if (w->tcpinfo && js_tcpinfo_is_slow(w->tcpinfo, elapsed_us)) {
+        struct tcp_info ti;
+        if (js_tcpinfo_get(c->socket.fd, &ti) == 0)
+            js_tcpinfo_add_slow(w->tcpinfo, &ti, elapsed_us, c->id, c->addr);
+    }
+}
+
+static void worker_stats_setup(js_stats_t *s, js_conn_t *c) {
+    /* With fast open the SYN waits for the first write: nothing to time */
+    if (c->opts == NULL || !c->opts->fast_open) {
+        s->connects++;
+        js_hist_add(&s->connect_latency,
+                    (double)(c->connected_ns - c->connect_ns) / 1000.0);
+    }
+
+    if (c->ssl) {
+        s->handshakes++;
+        if (SSL_session_reused(c->ssl)) s->handshakes_resumed++;
+        js_hist_add(&s->handshake_latency,
+                    (double)(c->handshake_ns - c->connected_ns) / 1000.0);
+    }
+}
+
+/*
+ * Count the connection's setup once it is complete (TCP, and TLS if any).
+ * Setups done before the measured window, or for preconnect, are left out.
+ */
+static void worker_count_setup(js_worker_t *w, js_conn_t *c) {
+    if (c->connect_ns == 0 || c->connected_ns == 0) return;
+    if (c->ssl && c->handshake_ns == 0) return;
+
+    if (c->ssl) {
+        w->tls_conns++;
+        w->ktls_tx += c->ktls_tx;
+        w->ktls_rx += c->ktls_rx;
+    }
+
+    if (w->barrier == NULL && c->connect_ns >= w->measure_ns)
+        worker_stats_setup(&w->stats, c);
+
+    c->connect_ns = 0;
+}
+
+static void worker_stats_error(js_stats_t *s, conn_state_t failed) {
+    s->errors++;
+
+    switch (failed) {
+        case CONN_WRITING:
+            s->write_errors++;
+            break;
+        case CONN_READING:
+        case CONN_DONE:
+        case CONN_IDLE:
+            s->read_errors++;
+            break;
+        default:
+            s->connect_errors++;
+            break;
+    }
+}
+
+/* Count a failed connection under the step it failed in */
+static void worker_count_error(js_worker_t *w, int addr, conn_state_t failed) {
+    worker_stats_error(&w->stats, failed);
+    if (w->addr_stats) w->addr_stats[addr].errors++;
+}
+
+static void worker_count_connect_error(js_worker_t *w, int addr) {
+    worker_count_error(w, addr, CONN_CONNECTING);
+}
+
+/*
+ * Pick the request to send after prev.  Request files are walked by a
+ * per-worker cursor, each worker taking every nworkers-th record.
+ */
+static int worker_next_request(js_worker_t *w, int prev) {
+    js_config_t *cfg = w->config;
+
+    if (cfg->reqfile) {
+        int idx = w->file_cursor;
+        w->file_cursor += w->nworkers;
+        if (w->file_cursor >= cfg->reqfile->count)
+            w->file_cursor = w->id % cfg->reqfile->count;
+        return idx;
+    }
+
+    return (prev + 1) % cfg->request_count;
+}
+
+/* Requests tried in a row before one is given up on */
+#define WORKER_RENDER_TRIES  8
+
+/* Build request idx into the connection's output buffer */
+static int worker_render(js_worker_t *w, js_conn_t *c, int idx) {
+    js_config_t *cfg = w->config;
+
+    if (cfg->reqfile)
+        return js_reqfile_render(cfg->reqfile, idx, &c->out);
+
+    js_conn_set_body(c, (cfg->bodies && cfg->bodies[idx].fd >= 0)
+                        ? &cfg->bodies[idx] : NULL);
+
+    if (cfg->templates && js_template_is_dynamic(&cfg->templates[idx]))
+        return js_template_render(&cfg->templates[idx], &w->tpl, c->id,
+                                  &c->out);
+
+    return js_conn_set_output(c, cfg->requests[idx].data,
+                              cfg->requests[idx].len);
+}
+
+/*
+ * Load request idx into the connection's output buffer.  Templated
+ * requests are rendered in place; the buffer is reused across requests.
+ * A request that fails to build (a malformed record, no memory) counts
+ * as an error and the next one is tried; when all the tries fail the
+ * request is left empty, which the write reports as one.  The last
+ * request bench.maxRequests allows on a connection asks the server to
+ * close it.
+ */
+static void worker_set_request(js_worker_t *w, js_conn_t *c, int idx) {
+    int max = w->config->max_requests;
+
+    for (int tries = 1; worker_render(w, c, idx) != 0; tries++) {
+        js_buf_reset(&c->out);
+        if (tries == WORKER_RENDER_TRIES) break;
+
+        worker_count_error(w, c->addr, CONN_WRITING);
+        idx = worker_next_request(w, idx);
+    }
+
+    if (max > 0 && c->requests + 1 >= max && c->out.len > 0)
+        js_request_set_close(&c->out);
+
+    c->req_index = idx;
+}
+
+/* ── Open-loop scheduling ─────────────────────────────────────────────── */
+
+/*
+ * Replay and rate-paced runs send each request when it is due, whatever
+ * the state of earlier ones, on any connection that is free at that
+ * moment.  New connections are opened as needed up to the worker's share;
+ * latency is measured from the scheduled time, so a late send counts
+ * against it.
+ */
+
+typedef struct {
+    js_worker_t      *worker;
+    js_timer_t        timer;
+    js_conn_t       **conns;
+    js_http_peer_t   *peers;
+    int              *idle;          /* stack of free slots */
+    int               nidle;
+    int               inflight;
+
+    /* Replay */
+    int               next;          /* next entry for this worker */
+
+    /* Fixed rate */
+    uint64_t          due_ns;        /* next send */
+    uint64_t          interval_ns;   /* 0: paused */
+    int               req_index;     /* last request sent */
+    double            rate;          /* requests per second, all workers */
+} worker_sched_t;
+
+static void worker_on_read(js_event_t *ev);
+static void worker_on_write(js_event_t *ev);
+static void worker_on_error(js_event_t *ev);
+
+static int worker_sched_send(worker_sched_t *ss, int slot, uint64_t due_ns) {
+    js_worker_t *w = ss->worker;
+    js_config_t *cfg = w->config;
+    js_engine_t *engine = js_thread()->engine;
+    js_http_peer_t *peer = &ss->peers[slot];
+    js_conn_t *c = ss->conns[slot];
+
+    if (c == NULL) {
+        int addr = worker_pick_addr(w, w->conn_base + slot);
+
+        c = worker_conn_create(w, addr);
+        if (!c) {
+            worker_count_connect_error(w, addr);
+            return -1;
+        }
+
+        js_http_response_init(&peer->response);
+        c->socket.data  = peer;
+        c->socket.read  = worker_on_read;
+        c->socket.write = worker_on_write;
+        c->socket.error = worker_on_error;
+        c->udata = w;
+        c->id = w->conn_base + slot;
+        ss->conns[slot] = c;
+
+    } else if (c->state == CONN_ERROR) {
+        /* Closed while idle: reconnect */
+        worker_conn_reconnect(w, c);
+        if (c->state == CONN_ERROR) {
+            worker_count_connect_error(w, c->addr);
+            return -1;
+        }
+        js_http_response_reset(&peer->response);
+
+    } else {
+        js_http_response_reset(&peer->response);
+        js_conn_reuse(c);
+    }
+
+    peer->start_ns = due_ns;
+
+    if (cfg->replay) {
+        js_replay_entry_t *e = &cfg->replay->entries[ss->next];
+        c->req_index = ss->next;
+        js_conn_set_output(c, cfg->replay->data.data + e->off, e->len);
+    } else {
+        ss->req_index = worker_next_request(w, ss->req_index);
+        c->req_index = ss->req_index;
+        worker_set_request(w, c, c->req_index);
+    }
+
+    if (c->state == CONN_WRITING) {
+        /* Open and registered already: write straight away */
+        js_conn_write(c);
+
+        if (c->state == CONN_ERROR) {
+            js_epoll_del(engine, &c->socket);
+            worker_count_error(w, c->addr, c->failed);
+            return -1;
+        }
+    } else {
+        js_epoll_add(engine, &c->socket, EPOLLIN | EPOLLOUT | EPOLLET);
+    }
+
+    ss->inflight++;
+    return 0;
+}
+
+/* When the next request is due; false if there is none (yet) */
+static bool worker_sched_due(worker_sched_t *ss, uint64_t *due) {
+    js_worker_t *w = ss->worker;
+    js_replay_t *rp = w->config->replay;
+
+    if (rp) {
+        if (ss->next >= rp->count) return false;
+        *due = w->start_ns + rp->entries[ss->next].at_us * 1000;
+        return true;
+    }
+
+    if (ss->interval_ns == 0) return false;
+    *due = ss->due_ns;
+    return true;
+}
+
+/* Send every request that is due, then sleep until the next one */
+static void worker_sched_dispatch(worker_sched_t *ss) {
+    js_worker_t *w = ss->worker;
+    js_engine_t *engine = js_thread()->engine;
+    uint64_t now = js_now_ns();
+    uint64_t due;
+
+    while (ss->nidle > 0 && worker_sched_due(ss, &due)) {
+        if (due > now) {
+            engine->timers.now = now / 1000;
+            js_timer_add(&engine->timers, &ss->timer,
+                         (due - now + 999) / 1000);
+            return;
+        }
+
+        int slot = ss->idle[--ss->nidle];
+
+        if (worker_sched_send(ss, slot, due) != 0) {
+            ss->idle[ss->nidle++] = slot;
+        }
+
+        if (w->config->replay) ss->next += w->nworkers;
+        else ss->due_ns += ss->interval_ns;
+    }
+}
+
+static void worker_sched_timer_handler(js_timer_t *timer, void *data) {
+    worker_sched_dispatch(data);
+}
+
+/* A request finished: park its connection and send whatever is due */
+static void worker_sched_complete(js_worker_t *w, js_conn_t *c,
+                                  bool keepalive) {
+    worker_sched_t *ss = w->sched;
+    js_http_peer_t *peer = c->socket.data;
+
+    if (keepalive && c->state == CONN_DONE) {
+        js_conn_idle(c);
+    } else {
+        js_epoll_del(js_thread()->engine, &c->socket);
+        c->state = CONN_ERROR;
+    }
+
+    ss->inflight--;
+    ss->idle[ss->nidle++] = (int) (peer - ss->peers);
+
+    if (!atomic_load(&w->stop)) worker_sched_dispatch(ss);
+}
+
+/*
+ * Throughput search: the controller bumps search->step to ask for a stats
+ * snapshot and to apply search->rate.  The snapshot is handed over before
+ * snap_step is published, so the controller may read it once it sees the
+ * new step.
+ */
+static void worker_search_poll(worker_sched_t *ss) {
+    js_worker_t *w = ss->worker;
+    js_search_t *s = w->config->search;
+    int step = atomic_load(&s->step);
+
+    if (step == atomic_load(&w->snap_step)) return;
+
+    *w->snapshot = w->stats;
+    js_stats_init(&w->stats);
+
+    if (s->rate != ss->rate) {
+        ss->rate = s->rate;
+        ss->interval_ns = ss->rate > 0
+                        ? (uint64_t) (1e9 * w->nworkers / ss->rate) : 0;
+        ss->due_ns = js_now_ns();
+        js_timer_delete(&js_thread()->engine->timers, &ss->timer);
+    }
+
+    atomic_store(&w->snap_step, step);
+    worker_sched_dispatch(ss);
+}
+
+/* ── TCP_INFO sampling ────────────────────────────────────────────────── */
+
+/*
+ * A timer walks the worker's connections, JS_TCPINFO_BATCH per tick, so
+ * the getsockopt() calls per second stay bounded however many
+ * connections there are.
+ */
+
+typedef struct {
+    js_worker_t      *worker;
+    js_timer_t        timer;
+    js_conn_t       **conns;
+    int               nconns;
+    int               cursor;
+    uint32_t         *retrans;      /* last tcpi_total_retrans per slot */
+} worker_tcpinfo_t;
+
+static void worker_tcpinfo_handler(js_timer_t *timer, void *data) {
+    worker_tcpinfo_t *ti = data;
+    js_worker_t *w = ti->worker;
+    int n = ti->nconns < JS_TCPINFO_BATCH ? ti->nconns : JS_TCPINFO_BATCH;
+
+    for (int k = 0; k < n; k++) {
+        int slot = ti->cursor;
+        js_conn_t *c = ti->conns[slot];
+        struct tcp_info info;
+
+        ti->cursor = (ti->cursor + 1) % ti->nconns;
+
+        if (c == NULL || c->state == CONN_CONNECTING || c->state == CONN_ERROR)
+            continue;
+        if (js_tcpinfo_get(c->socket.fd, &info) != 0)
+            continue;
+
+        /* A reconnected socket starts counting from zero */
+        uint32_t total = info.tcpi_total_retrans;
+        uint32_t last = ti->retrans[slot];
+
+        w->tcpinfo->retrans += total >= last ? total - last : total;
+        ti->retrans[slot] = total;
+
+        if (w->barrier == NULL) js_tcpinfo_add(w->tcpinfo, &info);
+    }
+
+    js_timer_add(&js_thread()->engine->timers, &ti->timer,
+                 (js_usec_t) w->config->tcpinfo_ms * 1000);
+}
+
+static void worker_tcpinfo_start(js_worker_t *w, worker_tcpinfo_t *ti,
+                                 js_conn_t **conns, int nconns) {
+    js_engine_t *engine = js_thread()->engine;
+
+    memset(ti, 0, sizeof(*ti));
+    if (w->tcpinfo == NULL || nconns <= 0) return;
+
+    ti->retrans = calloc((size_t)nconns, sizeof(uint32_t));
+    if (!ti->retrans) return;
+
+    ti->worker = w;
+    ti->conns = conns;
+    ti->nconns = nconns;
+    ti->timer.handler = worker_tcpinfo_handler;
+    ti->timer.data = ti;
+
+    engine->timers.now = js_now_ns() / 1000;
+    js_timer_add(&engine->timers, &ti->timer,
+                 (js_usec_t) w->config->tcpinfo_ms * 1000);
+}
+
+static void worker_tcpinfo_stop(worker_tcpinfo_t *ti) {
+    if (ti->retrans == NULL) return;
+
+    js_timer_delete(&js_thread()->engine->timers, &ti->timer);
+    free(ti->retrans);
+    ti->retrans = NULL;
+}
+
+/* ── C-path request completion ────────────────────────────────────────── */
+
+static void worker_conn_process(js_conn_t *c);
+
+/*
+ * Sockets are registered once, for EPOLLIN | EPOLLOUT | EPOLLET, until
+ * they are closed.  A request is written as soon as it is queued; only a
+ * write that hits EAGAIN waits for the EPOLLOUT edge.
+ */
+static void worker_conn_send(js_conn_t *c) {
+    js_conn_write(c);
+    if (c->state == CONN_ERROR) worker_conn_process(c);
+}
+
 static void worker_conn_process(js_conn_t *c) {
     js_worker_t *w = c->udata;
     js_http_peer_t *peer = c->socket.data;
     js_http_response_t *r = &peer->response;
-    js_config_t *cfg = w->config;
     js_engine_t *engine = js_thread()->engine;
 
+    if (c->state != CONN_ERROR) worker_count_setup(w, c);
+
     if (c->state == CONN_DONE) {
-        /* Record stats */
-        uint64_t elapsed_ns = js_now_ns() - peer->start_ns;
-        double elapsed_us = (double)elapsed_ns / 1000.0;
+        /* Record stats, unless the request was sent during warmup */
+        if (peer->start_ns >= w->measure_ns)
+            worker_count_response(w, c, r, peer->start_ns);
 
-        w->stats.requests++;
-        w->stats.bytes_read += r->body_len;
-        js_hist_add(&w->stats.latency, elapsed_us);
+        bool keep = worker_conn_keep(w, c, r);
 
-        int code = r->status_code;
-        if (code >= 200 && code < 300) w->stats.status_2xx++;
-        else if (code >= 300 && code < 400) w->stats.status_3xx++;
-        else if (code >= 400 && code < 500) w->stats.status_4xx++;
-        else if (code >= 500) w->stats.status_5xx++;
+        if (w->sched) {
+            worker_sched_complete(w, c, keep);
+            return;
+        }
 
         if (atomic_load(&w->stop)) return;
 
-        int next_idx = (c->req_index + 1) % cfg->request_count;
+        int next_idx = worker_next_request(w, c->req_index);
         c->req_index = next_idx;
 
-        if (worker_keepalive(r)) {
+        if (keep) {
             /* Reuse connection: reset parser, send next request */
             js_http_response_reset(r);
             js_conn_reuse(c);
             peer->start_ns = js_now_ns();
-            js_conn_set_output(c, cfg->requests[next_idx].data,
-                                 cfg->requests[next_idx].len);
-            js_epoll_mod(engine, &c->socket, EPOLLIN | EPOLLOUT | EPOLLET);
+            worker_set_request(w, c, next_idx);
+            worker_conn_send(c);
         } else {
-            /* Server closed: reconnect */
-            js_epoll_del(engine, &c->socket);
+            /*
+             * Server closed, or bench.maxRequests reached: reconnect.
+             * Closing the socket takes it out of epoll.
+             */
             js_http_response_reset(r);
-            js_conn_reset(c, (struct sockaddr *)&cfg->addr, cfg->addr_len,
-                          cfg->use_tls ? cfg->ssl_ctx : NULL,
-                          cfg->url.host);
+            worker_conn_reconnect(w, c);
 
             if (c->state == CONN_ERROR) {
-                w->stats.connect_errors++;
-                w->stats.errors++;
+                worker_count_connect_error(w, c->addr);
                 return;
             }
 
             peer->start_ns = js_now_ns();
-            js_conn_set_output(c, cfg->requests[next_idx].data,
-                                 cfg->requests[next_idx].len);
+            worker_set_request(w, c, next_idx);
             js_epoll_add(engine, &c->socket, EPOLLIN | EPOLLOUT | EPOLLET);
         }
 
     } else if (c->state == CONN_ERROR) {
-        w->stats.errors++;
-        w->stats.connect_errors++;
+        worker_count_error(w, c->addr, c->failed);
+
+        /* Failed during preconnect: leave it out of the run */
+        if (w->barrier) {
+            js_epoll_del(engine, &c->socket);
+            return;
+        }
+
+        if (w->sched) {
+            worker_sched_complete(w, c, false);
+            return;
+        }
 
         if (atomic_load(&w->stop)) return;
 
         /* Reconnect */
-        js_epoll_del(engine, &c->socket);
-
         int next_idx = c->req_index;
         js_http_response_reset(r);
-        js_conn_reset(c, (struct sockaddr *)&cfg->addr, cfg->addr_len,
-                      cfg->use_tls ? cfg->ssl_ctx : NULL,
-                      cfg->url.host);
+        worker_conn_reconnect(w, c);
 
         if (c->state == CONN_ERROR) {
-            w->stats.connect_errors++;
-            w->stats.errors++;
+            worker_count_connect_error(w, c->addr);
             return;
         }
 
         peer->start_ns = js_now_ns();
-        js_conn_set_output(c, cfg->requests[next_idx].data,
-                             cfg->requests[next_idx].len);
+        worker_set_request(w, c, next_idx);
         js_epoll_add(engine, &c->socket, EPOLLIN | EPOLLOUT | EPOLLET);
-    } else {
-        /* Still in progress, update epoll interest */
-        uint32_t mask = EPOLLET;
-        if (c->state == CONN_CONNECTING || c->state == CONN_WRITING ||
-            c->state == CONN_TLS_HANDSHAKE)
-            mask |= EPOLLOUT | EPOLLIN;
-        else
-            mask |= EPOLLIN;
-        js_epoll_mod(engine, &c->socket, mask);
     }
 }
 
+/* An idle open-loop connection was closed by the server; reopen it on demand */
+static void worker_idle_closed(js_conn_t *c) {
+    js_epoll_del(js_thread()->engine, &c->socket);
+    c->state = CONN_ERROR;
+}
+
 static void worker_on_read(js_event_t *ev) {
     js_conn_t *c = (js_conn_t *)ev;
     js_http_peer_t *peer = c->socket.data;
     js_http_response_t *r = &peer->response;
-    int rc = js_conn_read(c);
 
-    if (c->state == CONN_READING && c->in.len > 0) {
-        int ret = js_http_response_feed(r, c->in.data, c->in.len);
-        js_buf_reset(&c->in);
+    if (c->state == CONN_IDLE) {
+        if (js_conn_read(c) != 0) worker_idle_closed(c);
+        return;
+    }
 
-        if (ret == 1) {
-            c->state = CONN_DONE;
-        } else if (ret < 0) {
-            c->state = CONN_ERROR;
+    bool handshake = (c->state == CONN_TLS_HANDSHAKE);
+    int rc;
+
+    do {
+        c->skip = js_http_response_body_left(r);
+        rc = js_conn_read(c);
+
+        if (c->skipped > 0) {
+            if (js_http_response_skip(r, c->skipped) == 1)
+                c->state = CONN_DONE;
+            c->skipped = 0;
         }
-    }
+
+        if (c->state == CONN_READING && c->in.len > 0) {
+            int ret = js_http_response_feed(r, c->in.data, c->in.len);
+            js_buf_reset(&c->in);
+
+            if (ret == 1) {
+                c->state = CONN_DONE;
+            } else if (ret < 0) {
+                js_conn_error(c);
+            }
+        }
+    } while (rc == 2 && c->state == CONN_READING);
 
     if (rc == 1 && c->state == CONN_READING) {
         /* Peer closed before HTTP response complete */
         if (r->state == HTTP_PARSE_BODY_IDENTITY ||
-            r->body_len > 0) {
+            r->body_len > 0 || r->body_skipped > 0) {
             c->state = CONN_DONE;
         } else {
-            c->state = CONN_ERROR;
+            js_conn_error(c);
         }
     }
 
+    /* The TLS handshake finished on a read: no EPOLLOUT edge will follow */
+    if (handshake && c->state == CONN_WRITING) js_conn_write(c);
+
     worker_conn_process(c);
 }
 
 static void worker_on_write(js_event_t *ev) {
     js_conn_t *c = (js_conn_t *)ev;
+
+    /* EPOLLOUT comes along with every EPOLLIN while the socket is writable */
+    if (c->state == CONN_READING || c->state == CONN_IDLE) return;
+
     js_conn_write(c);
     worker_conn_process(c);
 }
 
+/*
+ * Send timestamps waiting on the error queue raise EPOLLERR too.  If that
+ * is all there is, handle the event as ordinary readiness.
+ */
+static bool worker_errqueue_only(js_conn_t *c) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+
+    js_conn_read_errqueue(c);
+
+    return getsockopt(c->socket.fd, SOL_SOCKET, SO_ERROR, &err, &len) == 0 &&
+           err == 0;
+}
+
 static void worker_on_error(js_event_t *ev) {
     js_conn_t *c = (js_conn_t *)ev;
-    c->state = CONN_ERROR;
+
+    if (c->timestamping && worker_errqueue_only(c)) {
+        worker_on_write(ev);
+        worker_on_read(ev);
+        return;
+    }
+
+    if (c->state == CONN_IDLE) {
+        worker_idle_closed(c);
+        return;
+    }
+
+    js_conn_error(c);
     worker_conn_process(c);
 }
 
 /* ── C-path worker: string/object/array modes ─────────────────────────── */
 
-static void worker_c_path(js_worker_t *w) {
-    js_config_t *cfg = w->config;
+/*
+ * Preconnect: run the loop until every connection has connected (and
+ * finished its TLS handshake) or failed.  Connections made without a
+ * request queued settle in CONN_IDLE.
+ */
+static void worker_preconnect(js_worker_t *w, js_conn_t **conns) {
     js_engine_t *engine = js_thread()->engine;
 
-    /* Duration timer */
-    js_timer_t duration_timer = {0};
+    for ( ;; ) {
+        int pending = 0;
 
-    if (cfg->duration_sec > 0) {
-        duration_timer.handler = worker_duration_handler;
-        duration_timer.data = &w->stop;
-        js_timer_add(&engine->timers, &duration_timer,
-                     (js_msec_t)(cfg->duration_sec * 1000));
+        w->connected = 0;
+        for (int i = 0; i < w->conn_count; i++) {
+            if (conns[i] == NULL) continue;
+            if (conns[i]->state == CONN_IDLE) w->connected++;
+            else if (conns[i]->state != CONN_ERROR) pending++;
+        }
+
+        if (pending == 0 || atomic_load(&w->stop)) break;
+        if (js_epoll_poll(engine, 100000) < 0) break;
     }
+}
+
+static void worker_c_path(js_worker_t *w) {
+    js_config_t *cfg = w->config;
+    js_engine_t *engine = js_thread()->engine;
+
+    js_tpl_vars_init(&w->tpl, w->id, w->nworkers);
+    if (cfg->reqfile) w->file_cursor = w->id % cfg->reqfile->count;
 
     /* Create connections */
     js_conn_t **conns = calloc((size_t)w->conn_count, sizeof(js_conn_t *));
     js_http_peer_t *peers = calloc((size_t)w->conn_count,
                                     sizeof(js_http_peer_t));
+    if (!conns || !peers) {
+        fprintf(stderr, "Worker %d: out of memory\n", w->id);
+        free(peers);
+        free(conns);
+        return;
+    }
+
     int active = 0;
 
     for (int i = 0; i < w->conn_count; i++) {
-        conns[i] = js_conn_create((struct sockaddr *)&cfg->addr, cfg->addr_len,
-                                    cfg->use_tls ? cfg->ssl_ctx : NULL,
-                                    cfg->url.host);
+        int addr = worker_pick_addr(w, w->conn_base + i);
+
+        conns[i] = worker_conn_create(w, addr);
         if (!conns[i]) {
-            w->stats.connect_errors++;
-            w->stats.errors++;
+            worker_count_connect_error(w, addr);
             continue;
         }
 
@@ -191,33 +1002,56 @@ static void worker_c_path(js_worker_t *w) {
         conns[i]->udata = w;
 
         /* Assign request (round-robin for array mode) */
-        int req_idx = i % cfg->request_count;
+        int req_idx = cfg->reqfile ? worker_next_request(w, 0)
+                                   : i % cfg->request_count;
         conns[i]->req_index = req_idx;
-        js_conn_set_output(conns[i], cfg->requests[req_idx].data,
-                             cfg->requests[req_idx].len);
+        conns[i]->id = w->conn_base + i;
+        conns[i]->preconnect = (w->barrier != NULL);
+        if (!w->barrier) worker_set_request(w, conns[i], req_idx);
 
         js_epoll_add(engine, &conns[i]->socket, EPOLLIN | EPOLLOUT | EPOLLET);
         active++;
     }
 
-    /* Event loop */
-    while (!atomic_load(&w->stop) && active > 0) {
-        js_msec_t timer_timeout = js_timer_find(&engine->timers);
-        int timeout;
+    if (w->barrier) {
+        worker_preconnect(w, conns);
+        worker_barrier(w);
 
-        if (timer_timeout == (js_msec_t) -1) {
-            timeout = 100;
-        } else {
-            timeout = (int) timer_timeout;
-            if (timeout > 100) timeout = 100;
+        /* Send the first request on every connection that made it */
+        for (int i = 0; i < w->conn_count; i++) {
+            js_conn_t *c = conns[i];
+            if (c == NULL) continue;
+
+            if (c->state != CONN_IDLE) {
+                active--;
+                continue;
+            }
+
+            c->preconnect = false;
+            js_conn_reuse(c);
+            peers[i].start_ns = js_now_ns();
+            worker_set_request(w, c, c->req_index);
+            worker_conn_send(c);
         }
+    }
+
+    /* Warmup and duration timers; setup is not the client's own cost */
+    js_timer_t warmup_timer = {0};
+    js_timer_t duration_timer = {0};
 
-        if (js_epoll_poll(engine, timeout) < 0) break;
+    worker_self_start(w);
+    worker_timers_start(w, &warmup_timer, &duration_timer);
 
-        engine->timers.now = (js_msec_t) (js_now_ns() / 1000000);
-        js_timer_expire(&engine->timers, engine->timers.now);
+    worker_tcpinfo_t tcpinfo;
+    worker_tcpinfo_start(w, &tcpinfo, conns, w->conn_count);
+
+    /* Event loop */
+    while (!atomic_load(&w->stop) && active > 0) {
+        if (worker_loop_once(w, worker_poll_timeout(w, 100000)) < 0) break;
     }
 
+    worker_tcpinfo_stop(&tcpinfo);
+
     /* Cleanup */
     for (int i = 0; i < w->conn_count; i++) {
         js_http_response_free(&peers[i].response);
@@ -227,6 +1061,76 @@ static void worker_c_path(js_worker_t *w) {
     free(conns);
 }
 
+/* ── C-path worker: replay and fixed-rate modes ───────────────────────── */
+
+static void worker_sched_path(js_worker_t *w) {
+    js_config_t *cfg = w->config;
+    int n = w->conn_count;
+
+    worker_sched_t ss = {
+        .worker = w,
+        .conns = calloc((size_t)n, sizeof(js_conn_t *)),
+        .peers = calloc((size_t)n, sizeof(js_http_peer_t)),
+        .idle = calloc((size_t)n, sizeof(int)),
+        .next = w->id,
+        .req_index = w->id - 1,
+    };
+
+    if (!ss.conns || !ss.peers || !ss.idle) {
+        fprintf(stderr, "Worker %d: out of memory\n", w->id);
+        free(ss.idle);
+        free(ss.peers);
+        free(ss.conns);
+        return;
+    }
+
+    /* Duration is an optional cap on the replay */
+    js_timer_t warmup_timer = {0};
+    js_timer_t duration_timer = {0};
+
+    worker_self_start(w);
+    if (!cfg->search) worker_timers_start(w, &warmup_timer, &duration_timer);
+
+    js_tpl_vars_init(&w->tpl, w->id, w->nworkers);
+    if (cfg->reqfile) w->file_cursor = w->id % cfg->reqfile->count;
+
+    ss.timer.handler = worker_sched_timer_handler;
+    ss.timer.data = &ss;
+
+    /* Lowest slots first, so connections are only opened when needed */
+    for (int i = n - 1; i >= 0; i--) ss.idle[ss.nidle++] = i;
+
+    worker_tcpinfo_t tcpinfo;
+    worker_tcpinfo_start(w, &tcpinfo, ss.conns, n);
+
+    w->sched = &ss;
+    worker_sched_dispatch(&ss);
+
+    /* Event loop */
+    while (!atomic_load(&w->stop) &&
+           (!cfg->replay || ss.next < cfg->replay->count || ss.inflight > 0))
+    {
+        int64_t timeout = worker_poll_timeout(w, cfg->search ? 10000 : 100000);
+
+        if (worker_loop_once(w, timeout) < 0) break;
+
+        if (cfg->search) worker_search_poll(&ss);
+    }
+
+    w->sched = NULL;
+    worker_tcpinfo_stop(&tcpinfo);
+
+    /* Cleanup */
+    for (int i = 0; i < n; i++) {
+        if (ss.conns[i] == NULL) continue;
+        js_http_response_free(&ss.peers[i].response);
+        js_conn_free(ss.conns[i]);
+    }
+    free(ss.idle);
+    free(ss.peers);
+    free(ss.conns);
+}
+
 /* ── JS-path worker: async function mode ──────────────────────────────── */
 
 static void worker_js_path(js_worker_t *w) {
@@ -266,18 +1170,35 @@ static void worker_js_path(js_worker_t *w) {
         return;
     }
 
-    /* Timer-based duration */
+    /* Timer-based warmup and duration */
+    uint64_t warmup_ns = 0;
     uint64_t deadline_ns = 0;
+    uint64_t now = js_now_ns();
+
+    w->measure_ns = w->start_ns;
+    worker_self_start(w);
+
+    if (cfg->warmup_sec > 0) {
+        warmup_ns = now + (uint64_t)(cfg->warmup_sec * 1e9);
+    }
     if (cfg->duration_sec > 0) {
-        deadline_ns = js_now_ns() + (uint64_t)(cfg->duration_sec * 1e9);
+        deadline_ns = now +
+                      (uint64_t)((cfg->warmup_sec + cfg->duration_sec) * 1e9);
     }
 
     /* Run the async function in a loop */
     while (!atomic_load(&w->stop)) {
-        if (deadline_ns > 0 && js_now_ns() >= deadline_ns) break;
-
         uint64_t start = js_now_ns();
 
+        if (deadline_ns > 0 && start >= deadline_ns) break;
+
+        if (warmup_ns > 0 && start >= warmup_ns) {
+            js_stats_init(&w->stats);
+            worker_self_start(w);
+            w->measure_ns = start;
+            warmup_ns = 0;
+        }
+
         /* Call the async function */
         JSValue promise = JS_Call(ctx, default_export, JS_UNDEFINED, 0, NULL);
         if (JS_IsException(promise)) {
@@ -294,6 +1215,8 @@ static void worker_js_path(js_worker_t *w) {
 
         JS_FreeValue(ctx, promise);
 
+        if (warmup_ns > 0) continue;
+
         uint64_t elapsed_ns = js_now_ns() - start;
         double elapsed_us = (double)elapsed_ns / 1000.0;
 
@@ -320,16 +1243,56 @@ void *js_worker_run(void *arg) {
     js_worker_t *w = arg;
     js_stats_init(&w->stats);
 
+    /*
+     * Allocated here so that the pages are local to the worker, unless
+     * bench_run already placed them in memory shared with worker processes
+     */
+    if (w->config->naddrs > 1 && !w->addr_stats) {
+        w->addr_stats = malloc(sizeof(js_addr_stats_t) *
+                               (size_t)w->config->naddrs);
+    }
+    if (w->config->tcpinfo_ms > 0 && !w->tcpinfo)
+        w->tcpinfo = malloc(sizeof(js_tcpinfo_t));
+    if (w->config->timestamps != JS_TSTAMP_NONE && !w->kernel_latency)
+        w->kernel_latency = malloc(sizeof(js_hist_t));
+    if (!w->loop_lag)
+        w->loop_lag = malloc(sizeof(js_hist_t));
+
+    if (w->tcpinfo) js_tcpinfo_init(w->tcpinfo);
+    if (w->kernel_latency) js_hist_init(w->kernel_latency);
+    if (w->addr_stats) {
+        for (int i = 0; i < w->config->naddrs; i++)
+            js_addr_stats_init(&w->addr_stats[i]);
+    }
+
     js_engine_t *engine = js_engine_create();
-    if (engine == NULL) return NULL;
+    if (engine == NULL || worker_tls_init(w) != 0) {
+        worker_tls_free(w);
+        if (engine) js_engine_destroy(engine);
+        worker_barrier(w);
+        return NULL;
+    }
     js_thread()->engine = engine;
 
+    /* Each path restarts this where its measured window begins */
+    if (w->config->perf) js_perf_open(&w->perf);
+    worker_self_start(w);
+
     if (w->config->mode == MODE_BENCH_ASYNC) {
         worker_js_path(w);
+    } else if (w->config->replay || w->config->search) {
+        worker_sched_path(w);
     } else {
         worker_c_path(w);
     }
 
+    /* A path that gave up before the barrier must not leave the rest waiting */
+    worker_barrier(w);
+
+    worker_self_stop(w);
+    if (w->config->perf) js_perf_close(&w->perf);
+
+    worker_tls_free(w);
     js_engine_destroy(engine);
     return NULL;
 }
@@ -21,6 +21,10 @@ cleanup() {
         kill "$SERVER_PID" 2>/dev/null || true
         wait "$SERVER_PID" 2>/dev/null || true
     fi
+    for pid in $AGENT_PIDS; do
+        kill "$pid" 2>/dev/null || true
+        wait "$pid" 2>/dev/null || true
+    done
 }
 trap cleanup EXIT
 
@@ -54,12 +58,14 @@ run_cli_test() {
     fi
 }
 
+# run_bench_test <name> <script> [jsb arguments before the script]
 run_bench_test() {
     local name="$1"
     local script="$2"
+    shift 2
     printf "  %-35s " "$name"
 
-    output=$("$JSB" "$script" 2>&1)
+    output=$("$JSB" "$@" "$script" 2>&1)
     exit_code=$?
 
     # Check that it ran successfully and produced stats
@@ -101,6 +107,33 @@ run_bench_test "Object export"       "$SCRIPT_DIR/scripts/bench_object.js"
 run_bench_test "Array round-robin"   "$SCRIPT_DIR/scripts/bench_array.js"
 run_bench_test "Async function"      "$SCRIPT_DIR/scripts/bench_async.js"
 run_bench_test "Options (conns/thr)" "$SCRIPT_DIR/scripts/bench_options.js"
+run_bench_test "Request templates"   "$SCRIPT_DIR/scripts/bench_template.js"
+run_bench_test "Request file"        "$SCRIPT_DIR/scripts/bench_file.js"
+run_bench_test "Replay"              "$SCRIPT_DIR/scripts/bench_replay.js"
+run_bench_test "Warmup"              "$SCRIPT_DIR/scripts/bench_warmup.js"
+run_bench_test "Preconnect"          "$SCRIPT_DIR/scripts/bench_preconnect.js"
+run_bench_test "Throughput search"   "$SCRIPT_DIR/scripts/bench_search.js"
+run_bench_test "Address list"        "$SCRIPT_DIR/scripts/bench_resolve.js"
+run_bench_test "Worker processes"    "$SCRIPT_DIR/scripts/bench_processes.js"
+run_bench_test "Connection churn"    "$SCRIPT_DIR/scripts/bench_churn.js"
+run_bench_test "Busy polling"        "$SCRIPT_DIR/scripts/bench_busypoll.js"
+run_bench_test "Kernel timestamps"   "$SCRIPT_DIR/scripts/bench_timestamps.js"
+run_bench_test "TCP_INFO sampling"   "$SCRIPT_DIR/scripts/bench_tcpinfo.js"
+run_bench_test "Socket options"      "$SCRIPT_DIR/scripts/bench_socket.js"
+run_bench_test "Large bodies"        "$SCRIPT_DIR/scripts/bench_large.js"
+run_bench_test "Streamed body"       "$SCRIPT_DIR/scripts/bench_body_stream.js"
+run_bench_test "Verbose stats"       "$SCRIPT_DIR/scripts/bench_stats_verbose.js"
+run_bench_test "Perf counters"       "$SCRIPT_DIR/scripts/bench_perf.js"
+
+echo ""
+echo -e "${YELLOW}=== Distributed Tests ===${NC}"
+AGENTS="127.0.0.1:18181,127.0.0.1:18182"
+for agent in ${AGENTS//,/ }; do
+    "$JSB" agent --listen "$agent" > /dev/null 2>&1 &
+    AGENT_PIDS="$AGENT_PIDS $!"
+done
+sleep 0.5
+run_bench_test "Two agents"          "$SCRIPT_DIR/scripts/bench_options.js" run --agents "$AGENTS"
 
 echo ""
 echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
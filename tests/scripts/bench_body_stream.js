@@ -0,0 +1,12 @@
+// Test: Generated request body streamed with sendfile()
+export const bench = {
+    connections: 5,
+    duration: '1s',
+    threads: 1
+};
+export default {
+    url: 'http://localhost:18080/echo',
+    method: 'POST',
+    headers: { 'Content-Type': 'application/octet-stream' },
+    body: { generate: '8KB' }
+};
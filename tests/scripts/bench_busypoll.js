@@ -0,0 +1,7 @@
+// Test: Workers spin on epoll_wait instead of sleeping
+export const bench = {
+    connections: 4,
+    duration: '1s',
+    busyPoll: true
+};
+export default 'http://localhost:18080/health';
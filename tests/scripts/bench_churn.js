@@ -0,0 +1,8 @@
+// Test: A new connection for every request, closed with RST
+export const bench = {
+    connections: 10,
+    duration: '1s',
+    keepalive: false,
+    resetOnClose: true
+};
+export default 'http://localhost:18080/health';
@@ -0,0 +1,10 @@
+// Test: Requests streamed from an NDJSON file
+export const bench = {
+    connections: 5,
+    duration: '1s',
+    threads: 2
+};
+export default {
+    file: 'requests.ndjson',
+    url: 'http://localhost:18080'
+};
@@ -0,0 +1,6 @@
+// Test: Response bodies dropped in the kernel, bytes still counted
+export const bench = {
+    connections: 10,
+    duration: '1s'
+};
+export default 'http://localhost:18080/large';
@@ -0,0 +1,7 @@
+// Test: Hardware counters; the run must succeed where they are unavailable
+export const bench = {
+    connections: 4,
+    duration: '1s',
+    perf: true
+};
+export default 'http://localhost:18080/health';
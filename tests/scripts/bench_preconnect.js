@@ -0,0 +1,8 @@
+// Test: Connections established before timing starts
+export const bench = {
+    connections: 50,
+    duration: '1s',
+    threads: 2,
+    preconnect: true
+};
+export default 'http://localhost:18080/health';
@@ -0,0 +1,8 @@
+// Test: Worker threads split over forked processes
+export const bench = {
+    connections: 20,
+    duration: '1s',
+    threads: 4,
+    processes: 2
+};
+export default 'http://localhost:18080/health';
@@ -0,0 +1,11 @@
+// Test: Replay an nginx access log at 4x speed
+export const bench = {
+    connections: 4,
+    threads: 2
+};
+export default {
+    replay: 'access.log',
+    format: 'nginx',
+    url: 'http://localhost:18080',
+    speedup: 4
+};
@@ -0,0 +1,9 @@
+// Test: Connections spread over an explicit address list
+export const bench = {
+    connections: 4,
+    duration: '1s',
+    threads: 2,
+    resolve: ['127.0.0.1', '127.0.0.2:18080'],
+    addressPolicy: 'roundrobin'
+};
+export default 'http://localhost:18080/health';
@@ -0,0 +1,13 @@
+// Test: Search for the highest rate within a latency SLO
+export const bench = {
+    connections: 10,
+    threads: 2,
+    search: {
+        p99: '100ms',
+        errorRate: 0.01,
+        step: '300ms',
+        start: 100,
+        max: 400
+    }
+};
+export default 'http://localhost:18080/health';
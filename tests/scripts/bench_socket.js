@@ -0,0 +1,13 @@
+// Test: Socket options on every connection, fast open on reconnect
+export const bench = {
+    connections: 10,
+    duration: '1s',
+    keepalive: false,
+    socket: {
+        fastOpen: true,
+        quickack: true,
+        sndbuf: '256KB',
+        rcvbuf: 262144
+    }
+};
+export default 'http://localhost:18080/health';
@@ -0,0 +1,8 @@
+// Test: Per-worker hot-path counters in the report
+export const bench = {
+    connections: 4,
+    threads: 2,
+    duration: '1s',
+    statsVerbose: true
+};
+export default 'http://localhost:18080/health';
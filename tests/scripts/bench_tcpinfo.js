@@ -0,0 +1,7 @@
+// Test: Periodic TCP_INFO samples and the slowest responses
+export const bench = {
+    connections: 10,
+    duration: '1s',
+    tcpInfo: '20ms'
+};
+export default 'http://localhost:18080/health';
@@ -0,0 +1,12 @@
+// Test: Request templates filled in by the C path
+export const bench = {
+    connections: 5,
+    duration: '1s',
+    threads: 2
+};
+export default {
+    url: 'http://localhost:18080/echo',
+    method: 'POST',
+    headers: { 'Content-Type': 'application/json', 'X-Request-Id': '${uuid}' },
+    body: '{"id":${counter},"conn":${conn},"n":${random(1,1e6)},"ts":${time}}'
+};
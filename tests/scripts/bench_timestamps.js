@@ -0,0 +1,7 @@
+// Test: Latency from SO_TIMESTAMPING send/receive timestamps
+export const bench = {
+    connections: 10,
+    duration: '1s',
+    timestamps: 'software'
+};
+export default 'http://localhost:18080/health';
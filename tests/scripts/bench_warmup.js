@@ -0,0 +1,7 @@
+// Test: Warmup period excluded from results
+export const bench = {
+    connections: 5,
+    duration: '1s',
+    warmup: '500ms'
+};
+export default 'http://localhost:18080/health';